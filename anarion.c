@@ -26,6 +26,10 @@
  */
 
 #include "config_anarion.h"
+#include "features/adaptive_term.h"
+#include "features/event_trace.h"
+#include "features/handler_profile.h"
+#include "features/keycode_class.h"
 
 // Needed for navigation keys on NAV layer
 typedef struct {
@@ -286,14 +290,26 @@ const custom_shift_key_t custom_shift_keys[] = {
 ///////////////////////////////////////////////////////////////////////////////
 // Tap-hold configuration (https://docs.qmk.fm/tap_hold)
 ///////////////////////////////////////////////////////////////////////////////
+#ifdef ADAPTIVE_TERM_ENABLE
+const uint16_t adaptive_term_keys[] = {
+    HRM_A, HRM_S, HRM_D,    HRM_F,   HRM_G,    HRM_B,     HRM_J,
+    HRM_K, HRM_L, HRM_SEMI, SPC_NAV, ENT_SHFT, BSPC_RALT,
+};
+uint8_t NUM_ADAPTIVE_TERM_KEYS =
+    sizeof(adaptive_term_keys) / sizeof(*adaptive_term_keys);
+#else
+// Without Adaptive Term, use the given default terms.
+#define adaptive_term_tapping_term(keycode, default_term) (default_term)
+#endif  // ADAPTIVE_TERM_ENABLE
+
 uint16_t get_tapping_term(uint16_t keycode, keyrecord_t* record) {
   switch (keycode) {
     case ENT_SHFT:
     case SPC_NAV:
     case BSPC_RALT:
-      return TAPPING_TERM - 35;
+      return adaptive_term_tapping_term(keycode, TAPPING_TERM - 35);
     default:
-      return TAPPING_TERM;
+      return adaptive_term_tapping_term(keycode, TAPPING_TERM);
   }
 }
 
@@ -426,14 +442,18 @@ bool apply_autocorrect(uint8_t backspaces, const char* str, char* typo,
 ///////////////////////////////////////////////////////////////////////////////
 #ifdef CAPS_WORD_ENABLE
 bool caps_word_press_user(uint16_t keycode) {
-  switch (keycode) {
-    // Keycodes that continue Caps Word, with shift applied.
-    case KC_A ... KC_Z:
-      add_weak_mods(MOD_BIT_LSHIFT);  // Apply shift to the next key.
-      return true;
+  const uint8_t flags = get_keycode_class(keycode);
+  // Keycodes that continue Caps Word, with shift applied.
+  if (flags & KEYCODE_CLASS_ALPHA) {
+    add_weak_mods(MOD_BIT_LSHIFT);  // Apply shift to the next key.
+    return true;
+  }
 
-    // Keycodes that continue Caps Word, without shifting.
-    case KC_1 ... KC_0:
+  // Keycodes that continue Caps Word, without shifting.
+  if (flags & KEYCODE_CLASS_DIGIT) {
+    return true;
+  }
+  switch (keycode) {
     case KC_BSPC:
     case KC_DEL:
     case KC_UNDS:
@@ -455,30 +475,24 @@ char sentence_case_press_user(uint16_t keycode, keyrecord_t* record,
   if ((mods & ~(MOD_MASK_SHIFT | MOD_BIT_RALT)) == 0) {
     const bool shifted = mods & MOD_MASK_SHIFT;
     switch (keycode) {
-      case KC_A ... KC_Z:
-        return 'a';  // Letter key.
-
       case KC_DOT:  // Both . and Shift . (?) punctuate sentence endings.
-      case KC_EXLM:
-      case KC_QUES:
         return '.';
 
       case KC_COMM:
         return shifted ? '.' : '#';
+    }
 
-      case KC_2 ... KC_0:  // 2 3 4 5 6 7 8 9 0
-      case KC_AT ... KC_RPRN:  // @ # $ % ^ & * ( )
-      case KC_MINS ... KC_SCLN:  // - = [ ] backslash ;
-      case KC_UNDS ... KC_COLN:  // _ + { } | :
-      case KC_GRV:
-        return '#';  // Symbol key.
-
-      case KC_SPC:
-        return ' ';  // Space key.
-
-      case KC_QUOT:
-      case KC_DQUO:
-        return '\'';  // Quote key.
+    const uint8_t flags = get_typed_keycode_class(keycode, shifted);
+    if (flags & KEYCODE_CLASS_ALPHA) {
+      return 'a';  // Letter key.
+    } else if (flags & KEYCODE_CLASS_ENDING) {
+      return '.';  // ! ?
+    } else if (flags & KEYCODE_CLASS_SYMBOL) {
+      return '#';  // Symbol key.
+    } else if (flags & KEYCODE_CLASS_SPACE) {
+      return ' ';  // Space key.
+    } else if (flags & KEYCODE_CLASS_QUOTE) {
+      return '\'';  // Quote or double quote key.
     }
   }
 
@@ -511,7 +525,11 @@ static void lighting_preset(uint8_t effect, uint8_t palette) {
 ///////////////////////////////////////////////////////////////////////////////
 // Debug logging
 ///////////////////////////////////////////////////////////////////////////////
-#ifndef NO_DEBUG
+#if defined(EVENT_TRACE_ENABLE) && !defined(NO_DEBUG)
+#pragma message "dlog_record: event trace"
+// Key events are logged as compact binary records, see features/event_trace.h.
+#define dlog_record(keycode, record) process_event_trace((keycode), (record))
+#elif !defined(NO_DEBUG)
 #pragma message "dlog_record: enabled"
 
 #ifdef KEYCODE_STRING_ENABLE
@@ -537,10 +555,15 @@ static void dlog_record(uint16_t keycode, keyrecord_t* record) {
   } else {  // Log the "(row,col)" position.
     xprintf("(%2u,%2u) ", record->event.key.row, record->event.key.col);
   }
-  xprintf("%-4s %-7s %s\n",  // "(tap|hold) (press|release) <keycode>".
+  xprintf("%-4s %-7s ",  // "(tap|hold) (press|release) <keycode>".
           is_tap_hold ? (record->tap.count ? "tap" : "hold") : "",
-          record->event.pressed ? "press" : "release",
-          get_keycode_string(keycode));
+          record->event.pressed ? "press" : "release");
+#ifdef KEYCODE_STRING_NUMERIC
+  // Named on the host, with tools/host_sim/trace_decode -t.
+  xprintf("0x%04X\n", keycode);
+#else
+  xprintf("%s\n", get_keycode_string(keycode));
+#endif  // KEYCODE_STRING_NUMERIC
 }
 #else
 #pragma message "dlog_record: disabled"
@@ -588,8 +611,28 @@ void keyboard_post_init_user(void) {
 #endif  // defined(AUDIO_ENABLE) && defined(MUSHROOM_SOUND)
 }
 
+#if defined(ADAPTIVE_TERM_ENABLE) || defined(HANDLER_PROFILE_ENABLE) || \
+    defined(EVENT_TRACE_ENABLE)
+void housekeeping_task_user(void) {
+#ifdef ADAPTIVE_TERM_ENABLE
+  adaptive_term_task();
+#endif  // ADAPTIVE_TERM_ENABLE
+#ifdef HANDLER_PROFILE_ENABLE
+  handler_profile_task();
+#endif  // HANDLER_PROFILE_ENABLE
+#ifdef EVENT_TRACE_ENABLE
+  event_trace_task();
+#endif  // EVENT_TRACE_ENABLE
+}
+#endif  // defined(ADAPTIVE_TERM_ENABLE) || defined(HANDLER_PROFILE_ENABLE) ||
+        // defined(EVENT_TRACE_ENABLE)
+
 bool process_record_user(uint16_t keycode, keyrecord_t* record) {
+  HANDLER_PROFILE_SCOPE(HANDLER_PROFILE_USER);
   dlog_record(keycode, record);
+#ifdef ADAPTIVE_TERM_ENABLE
+  process_adaptive_term(keycode, record);
+#endif  // ADAPTIVE_TERM_ENABLE
 
   // // Track whether the left home ring and index keys are held, ignoring
   // layer. static bool left_home_ring_held = false; static bool
@@ -28,6 +28,21 @@
 #define QUICK_TAP_TERM_PER_KEY
 #define HOLD_ON_OTHER_KEY_PRESS_PER_KEY
 
+#ifdef ADAPTIVE_TERM_ENABLE
+// Learn tapping terms for the 13 tap-hold keys, see features/adaptive_term.h.
+#define ADAPTIVE_TERM_MAX_KEYS 13
+// With debug on, print the learned histograms every minute.
+#define ADAPTIVE_TERM_DUMP_INTERVAL 60000
+#endif  // ADAPTIVE_TERM_ENABLE
+
+#if defined(ADAPTIVE_TERM_ENABLE) || defined(ORBITAL_MOUSE_ACCEL_PROFILES)
+// The EEPROM user data block holds Adaptive Term's histograms,
+// ADAPTIVE_TERM_EEPROM_SIZE = 2 + 13 * (2 + 3 * 16) = 652 bytes, followed by
+// Orbital Mouse's acceleration profiles, ORBITAL_MOUSE_EEPROM_SIZE =
+// 3 + 3 * (1 + 3 * 3) = 33 bytes.
+#define EECONFIG_USER_DATA_SIZE 685
+#endif  // defined(ADAPTIVE_TERM_ENABLE) ||
+
 // Uncomment this line for verbose QMK core tap-hold logging.
 // #define ACTION_DEBUG
 
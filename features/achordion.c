@@ -22,6 +22,10 @@
 
 #include "achordion.h"
 
+#if defined(ACHORDION_STREAK) && defined(ADAPTIVE_TERM_ENABLE)
+#include "adaptive_term.h"
+#endif  // defined(ACHORDION_STREAK) && defined(ADAPTIVE_TERM_ENABLE)
+
 #pragma message \
     "Achordion has evolved into core QMK feature Chordal Hold! To use it, update your QMK set up and see https://docs.qmk.fm/tap_hold#chordal-hold"
 
@@ -31,42 +35,72 @@
 #error "achordion: QMK version is too old to build. Please update QMK."
 #else
 
-// Copy of the `record` and `keycode` args for the current active tap-hold key.
-static keyrecord_t tap_hold_record;
-static uint16_t tap_hold_keycode = KC_NO;
-// Timeout timer. When it expires, the key is considered held.
-static uint16_t hold_timer = 0;
-// Eagerly applied mods, if any.
-static uint8_t eager_mods = 0;
-// Flag to determine whether another key is pressed within the timeout.
-static bool pressed_another_key_before_release = false;
-
-#ifdef ACHORDION_STREAK
-// Timer for typing streak
-static uint16_t streak_timer = 0;
-#else
-// When disabled, is_streak is never true
-#define is_streak false
+#if ACHORDION_MAX_PENDING < 1 || ACHORDION_MAX_PENDING > 16
+#error "achordion: ACHORDION_MAX_PENDING must be between 1 and 16."
+#endif
+#if ACHORDION_QUEUE_SIZE < 1 || ACHORDION_QUEUE_SIZE > 255
+#error "achordion: ACHORDION_QUEUE_SIZE must be between 1 and 255."
 #endif
 
-// Achordion's current state.
+// State of a tap-hold key tracked by Achordion.
 enum {
-  // A tap-hold key is pressed, but hasn't yet been settled as tapped or held.
+  // The key is pressed, but hasn't yet been settled as tapped or held.
   STATE_UNSETTLED,
-  // Achordion is inactive.
-  STATE_RELEASED,
-  // Active tap-hold key has been settled as tapped.
+  // The key has been settled as tapped.
   STATE_TAPPING,
-  // Active tap-hold key has been settled as held.
+  // The key has been settled as held.
   STATE_HOLDING,
-  // This state is set while calling `process_record()`, which will recursively
-  // call `process_achordion()`. This state is checked so that we don't process
-  // events generated by Achordion and potentially create an infinite loop.
-  STATE_RECURSING,
 };
-static uint8_t achordion_state = STATE_RELEASED;
+
+typedef struct {
+  // Copy of the `record` and `keycode` args for the key's press event.
+  keyrecord_t record;
+  uint16_t keycode;
+  // Timeout timer. When it expires, the key is considered held.
+  uint16_t hold_timer;
+  // Eagerly applied mods, if any.
+  uint8_t eager_mods;
+  uint8_t state;
+  // Flag to determine whether another key is pressed within the timeout.
+  bool pressed_another_key_before_release;
+} tap_hold_t;
+
+// Tracked tap-hold keys in the order they were pressed. A key stays in the
+// table from its press until its release, also after it is settled, so that
+// its release can be plumbed accordingly. Unsettled keys are always settled
+// in order, so that their taps and holds are sent in the order they were
+// pressed.
+static tap_hold_t tap_holds[ACHORDION_MAX_PENDING];
+static uint8_t num_tap_holds = 0;
+
+// An event to be replayed through `process_record()` or, if `action` is set,
+// through `process_action()`.
+typedef struct {
+  keyrecord_t record;
+  uint16_t action;
+  // Milliseconds to wait after the previous event before replaying this one.
+  uint8_t delay;
+} event_t;
+
+// Queue of events generated by Achordion, as a ring buffer. The taps and holds
+// that settle tap-hold keys, and the events they interrupted, are replayed from
+// `achordion_task()` rather than by re-entering `process_record()` from within
+// the handler. So the stack depth doesn't grow with the number of keys, and
+// TAP_CODE_DELAY between a tap's press and release doesn't block.
+static event_t event_queue[ACHORDION_QUEUE_SIZE];
+static uint8_t event_queue_head = 0;
+static uint8_t event_queue_size = 0;
+// Time when the last event was replayed.
+static uint16_t replay_time = 0;
+// This is set while replaying events, which calls `process_achordion()`. This
+// is checked so that we don't process events generated by Achordion and
+// potentially create an infinite loop.
+static bool replaying = false;
 
 #ifdef ACHORDION_STREAK
+// Timer for typing streak
+static uint16_t streak_timer = 0;
+
 static void update_streak_timer(uint16_t keycode, keyrecord_t* record) {
   if (achordion_streak_continue(keycode)) {
     // We use 0 to represent an unset timer, so `| 1` to force a nonzero value.
@@ -75,83 +109,254 @@ static void update_streak_timer(uint16_t keycode, keyrecord_t* record) {
     streak_timer = 0;
   }
 }
-#endif
 
-// Presses or releases eager_mods through process_action(), which skips the
-// usual event handling pipeline. The action is considered as a mod-tap hold or
-// release, with Retro Tapping if enabled.
-static void process_eager_mods_action(void) {
-  action_t action;
-  action.code = ACTION_MODS_TAP_KEY(
-      eager_mods, QK_MOD_TAP_GET_TAP_KEYCODE(tap_hold_keycode));
-  process_action(&tap_hold_record, action);
+// Returns true if pressing `keycode` while `t` is unsettled continues a typing
+// streak, in which case `t` is settled as tapped.
+static bool in_streak(const tap_hold_t* t, uint16_t keycode,
+                      keyrecord_t* record) {
+  const uint16_t s_timeout =
+      achordion_streak_chord_timeout(t->keycode, keycode);
+  return streak_timer && s_timeout &&
+         !timer_expired(record->event.time, (streak_timer + s_timeout));
 }
+#else
+// When disabled, in_streak is never true
+#define in_streak(t, keycode, record) false
+#endif
+
+// Replays the event at the front of the queue and removes it.
+static void replay_event(void) {
+  event_t* e = &event_queue[event_queue_head];
+  event_queue_head = (event_queue_head + 1) % ACHORDION_QUEUE_SIZE;
+  --event_queue_size;
 
-// Calls `process_record()` with state set to RECURSING.
-static void recursively_process_record(keyrecord_t* record, uint8_t state) {
-  achordion_state = STATE_RECURSING;
+  replaying = true;
+  if (e->action) {
+    action_t action;
+    action.code = e->action;
+    process_action(&e->record, action);
+  } else {
 #if defined(POINTING_DEVICE_ENABLE) && defined(POINTING_DEVICE_AUTO_MOUSE_ENABLE)
-  int8_t mouse_key_tracker = get_auto_mouse_key_tracker();
+    int8_t mouse_key_tracker = get_auto_mouse_key_tracker();
 #endif
-  process_record(record);
+    process_record(&e->record);
 #if defined(POINTING_DEVICE_ENABLE) && defined(POINTING_DEVICE_AUTO_MOUSE_ENABLE)
-  set_auto_mouse_key_tracker(mouse_key_tracker);
+    set_auto_mouse_key_tracker(mouse_key_tracker);
 #endif
-  achordion_state = state;
+  }
+  replaying = false;
+  replay_time = timer_read();
+
+  // If the next event is delayed, send the report now so that the host sees
+  // this event before the delay.
+  if (event_queue_size > 0 && event_queue[event_queue_head].delay) {
+    send_keyboard_report();
+  }
+}
+
+// Replays the queued events that are due.
+static void replay_events(void) {
+  while (event_queue_size > 0) {
+    const uint8_t delay = event_queue[event_queue_head].delay;
+    if (delay && !timer_expired(timer_read(), replay_time + delay)) {
+      break;
+    }
+    replay_event();
+  }
+}
+
+// Adds an event to the queue. `action` is an action code to replay through
+// `process_action()`, or 0 to replay `record` through `process_record()`.
+static void enqueue_event(const keyrecord_t* record, uint16_t action,
+                          uint8_t delay) {
+  if (event_queue_size >= ACHORDION_QUEUE_SIZE) {
+    // The queue is full. This shouldn't happen with a large enough queue, but
+    // if it does, replay the oldest event immediately to make room.
+    dprintln("Achordion: Event queue full.");
+    if (event_queue[event_queue_head].delay) {
+      wait_ms(event_queue[event_queue_head].delay);
+    }
+    replay_event();
+  }
+  event_t* e = &event_queue[(event_queue_head + event_queue_size) %
+                            ACHORDION_QUEUE_SIZE];
+  ++event_queue_size;
+  e->record = *record;
+  e->action = action;
+  e->delay = delay;
+}
+
+// Presses or releases the key's eager_mods through process_action(), which
+// skips the usual event handling pipeline. The action is considered as a
+// mod-tap hold or release, with Retro Tapping if enabled.
+static void process_eager_mods_action(tap_hold_t* t) {
+  enqueue_event(&t->record,
+                ACTION_MODS_TAP_KEY(t->eager_mods,
+                                    QK_MOD_TAP_GET_TAP_KEYCODE(t->keycode)),
+                0);
 }
 
-// Sends hold press event and settles the active tap-hold key as held.
-static void settle_as_hold(void) {
-  if (eager_mods) {
+// Sends hold press event and settles the tap-hold key as held.
+static void settle_as_hold(tap_hold_t* t) {
+  t->state = STATE_HOLDING;
+  if (t->eager_mods) {
     // If eager mods are being applied, nothing needs to be done besides
     // updating the state.
     dprintln("Achordion: Settled eager mod as hold.");
-    achordion_state = STATE_HOLDING;
   } else {
     // Create hold press event.
     dprintln("Achordion: Plumbing hold press.");
-    recursively_process_record(&tap_hold_record, STATE_HOLDING);
+    enqueue_event(&t->record, 0, 0);
   }
 }
 
-// Sends tap press and release and settles the active tap-hold key as tapped.
-static void settle_as_tap(void) {
-  if (eager_mods) {  // Clear eager mods if set.
+// Sends tap press and release and settles the tap-hold key as tapped.
+static void settle_as_tap(tap_hold_t* t) {
+  t->state = STATE_TAPPING;
+  if (t->eager_mods) {  // Clear eager mods if set.
 #if defined(RETRO_TAPPING) || defined(RETRO_TAPPING_PER_KEY)
 #ifdef DUMMY_MOD_NEUTRALIZER_KEYCODE
     neutralize_flashing_modifiers(get_mods());
 #endif  // DUMMY_MOD_NEUTRALIZER_KEYCODE
 #endif  // defined(RETRO_TAPPING) || defined(RETRO_TAPPING_PER_KEY)
-    tap_hold_record.event.pressed = false;
+    t->record.event.pressed = false;
     // To avoid falsely triggering Retro Tapping, process eager mods release as
     // a regular mods release rather than a mod-tap release.
-    action_t action;
-    action.code = ACTION_MODS(eager_mods);
-    process_action(&tap_hold_record, action);
-    eager_mods = 0;
+    enqueue_event(&t->record, ACTION_MODS(t->eager_mods), 0);
+    t->eager_mods = 0;
   }
 
   dprintln("Achordion: Plumbing tap press.");
-  tap_hold_record.event.pressed = true;
-  tap_hold_record.tap.count = 1;  // Revise event as a tap.
-  tap_hold_record.tap.interrupted = true;
+  t->record.event.pressed = true;
+  t->record.tap.count = 1;  // Revise event as a tap.
+  t->record.tap.interrupted = true;
   // Plumb tap press event.
-  recursively_process_record(&tap_hold_record, STATE_TAPPING);
-
-  send_keyboard_report();
-#if TAP_CODE_DELAY > 0
-  wait_ms(TAP_CODE_DELAY);
-#endif  // TAP_CODE_DELAY > 0
+  enqueue_event(&t->record, 0, 0);
 
   dprintln("Achordion: Plumbing tap release.");
-  tap_hold_record.event.pressed = false;
-  // Plumb tap release event.
-  recursively_process_record(&tap_hold_record, STATE_TAPPING);
+  t->record.event.pressed = false;
+  // Plumb tap release event, TAP_CODE_DELAY after the press.
+  enqueue_event(&t->record, 0, TAP_CODE_DELAY);
+}
+
+// Flags returned by settle_pending().
+enum {
+  SETTLED_TAP = 1,
+  SETTLED_LAYER_TAP_HOLD = 2,
+};
+
+// Settles the unsettled keys among the first `end` tracked keys, in the order
+// they were pressed, on the press of another key. Each is settled as held if
+// `force_hold` or `achordion_chord()` with the other key says so, and
+// otherwise as tapped. Returns a combination of SETTLED_* flags.
+static uint8_t settle_pending(uint8_t end, uint16_t other_keycode,
+                              keyrecord_t* other_record, bool force_hold) {
+  uint8_t settled = 0;
+  for (uint8_t i = 0; i < end; ++i) {
+    tap_hold_t* t = &tap_holds[i];
+    if (t->state != STATE_UNSETTLED) {
+      continue;
+    }
+    if (!in_streak(t, other_keycode, other_record) &&
+        (force_hold || achordion_chord(t->keycode, &t->record, other_keycode,
+                                       other_record))) {
+      settle_as_hold(t);
+      if (IS_QK_LAYER_TAP(t->keycode)) {
+        settled |= SETTLED_LAYER_TAP_HOLD;
+      }
+    } else {
+      settle_as_tap(t);
+      settled |= SETTLED_TAP;
+    }
+  }
+  return settled;
+}
+
+// Starts tracking a tap-hold key that QMK considers "held".
+static void add_tap_hold(uint16_t keycode, keyrecord_t* record,
+                         uint16_t timeout, bool allow_eager_mods) {
+  tap_hold_t* t = &tap_holds[num_tap_holds++];
+  t->record = *record;
+  t->keycode = keycode;
+  t->hold_timer = record->event.time + timeout;
+  t->eager_mods = 0;
+  t->state = STATE_UNSETTLED;
+  t->pressed_another_key_before_release = false;
+
+  if (allow_eager_mods && IS_QK_MOD_TAP(keycode)) {
+    // Apply mods immediately if they are "eager."
+    const uint8_t mod = mod_config(QK_MOD_TAP_GET_MODS(keycode));
+    if (
+#if defined(CAPS_WORD_ENABLE)
+        // Since eager mods bypass normal event handling, Caps Word does not
+        // work as expected with eager Shift. So we don't apply Shift eagerly
+        // while Caps Word is on.
+        !(is_caps_word_on() && (mod & MOD_LSFT) != 0) &&
+#endif  // defined(CAPS_WORD_ENABLE)
+        achordion_eager_mod(mod)) {
+      t->eager_mods = mod;
+      process_eager_mods_action(t);
+    }
+  }
+
+  dprintf("Achordion: Key 0x%04X pressed.%s\n", keycode,
+          t->eager_mods ? " Set eager mods." : "");
+}
+
+// Handles the release of tracked key `i` and stops tracking it.
+static void release_tap_hold(uint8_t i) {
+  tap_hold_t* t = &tap_holds[i];
+
+  if (t->state == STATE_UNSETTLED) {
+    // Keys pressed before this one must be settled first. They and this key
+    // are settled by the key pressed next after this one, if any.
+    if (i + 1 < num_tap_holds && i + 1 < ACHORDION_MAX_PENDING) {
+      tap_hold_t* next = &tap_holds[i + 1];
+      settle_pending(i + 1, next->keycode, &next->record, false);
+    } else {
+      settle_pending(i, t->keycode, &t->record, false);
+    }
+  }
+
+  if (t->eager_mods) {
+    dprintln("Achordion: Key released. Clearing eager mods.");
+    t->record.event.pressed = false;
+    process_eager_mods_action(t);
+  } else if (t->state == STATE_HOLDING) {
+    dprintln("Achordion: Key released. Plumbing hold release.");
+    t->record.event.pressed = false;
+    // Plumb hold release event.
+    enqueue_event(&t->record, 0, 0);
+  } else if (t->state == STATE_UNSETTLED &&
+             !t->pressed_another_key_before_release) {
+    // No other key was pressed between the press and release of the tap-hold
+    // key, plumb a hold press and then a release.
+    dprintln("Achordion: Key released. Plumbing hold press and release.");
+    enqueue_event(&t->record, 0, 0);
+    t->record.event.pressed = false;
+    enqueue_event(&t->record, 0, 0);
+  } else {
+    dprintln("Achordion: Key released.");
+  }
+
+  --num_tap_holds;
+  memmove(t, t + 1, (num_tap_holds - i) * sizeof(tap_hold_t));
+}
+
+// Returns the number of tracked keys up to and including the last unsettled
+// one, or 0 if none are unsettled.
+static uint8_t pending_end(void) {
+  for (uint8_t i = num_tap_holds; i > 0; --i) {
+    if (tap_holds[i - 1].state == STATE_UNSETTLED) {
+      return i;
+    }
+  }
+  return 0;
 }
 
 bool process_achordion(uint16_t keycode, keyrecord_t* record) {
   // Don't process events that Achordion generated.
-  if (achordion_state == STATE_RECURSING) {
+  if (replaying) {
     return true;
   }
 
@@ -161,152 +366,129 @@ bool process_achordion(uint16_t keycode, keyrecord_t* record) {
   // Check that this is a normal key event, don't act on combos.
   const bool is_key_event = IS_KEYEVENT(record->event);
 
-  // Event while no tap-hold key is active.
-  if (achordion_state == STATE_RELEASED) {
-    if (is_tap_hold && record->tap.count == 0 && record->event.pressed &&
-        is_key_event) {
-      // A tap-hold key is pressed and considered by QMK as "held".
-      const uint16_t timeout = achordion_timeout(keycode);
-      if (timeout > 0) {
-        achordion_state = STATE_UNSETTLED;
-        // Save info about this key.
-        tap_hold_keycode = keycode;
-        tap_hold_record = *record;
-        hold_timer = record->event.time + timeout;
-        pressed_another_key_before_release = false;
-        eager_mods = 0;
-
-        if (is_mt) {  // Apply mods immediately if they are "eager."
-          const uint8_t mod = mod_config(QK_MOD_TAP_GET_MODS(keycode));
-          if (
-#if defined(CAPS_WORD_ENABLE)
-              // Since eager mods bypass normal event handling, Caps Word does
-              // not work as expected with eager Shift. So we don't apply Shift
-              // eagerly while Caps Word is on.
-              !(is_caps_word_on() && (mod & MOD_LSFT) != 0) &&
-#endif  // defined(CAPS_WORD_ENABLE)
-              achordion_eager_mod(mod)) {
-            eager_mods = mod;
-            process_eager_mods_action();
-          }
-        }
-
-        dprintf("Achordion: Key 0x%04X pressed.%s\n", keycode,
-                eager_mods ? " Set eager mods." : "");
-        return false;  // Skip default handling.
+  if (record->event.pressed) {
+    // Track whether another key was pressed while using a tap-hold key.
+    for (uint8_t i = 0; i < num_tap_holds; ++i) {
+      if (tap_holds[i].keycode != keycode) {
+        tap_holds[i].pressed_another_key_before_release = true;
       }
     }
+  } else {
+    // Release of a tracked tap-hold key.
+    for (uint8_t i = 0; i < num_tap_holds; ++i) {
+      if (tap_holds[i].keycode == keycode) {
+        release_tap_hold(i);
+        return false;
+      }
+    }
+  }
 
+  if (is_tap_hold && record->tap.count == 0 && record->event.pressed &&
+      is_key_event) {
+    // A tap-hold key is pressed and considered by QMK as "held".
+    const uint16_t timeout = achordion_timeout(keycode);
+    if (timeout > 0) {
+      // Eager mods are applied only if no other key is pending, since they
+      // would otherwise apply to the taps of the keys pressed before.
+      bool allow_eager_mods = (pending_end() == 0);
 #ifdef ACHORDION_STREAK
-    update_streak_timer(keycode, record);
+      // If we are in a streak, settle the pending tap-hold keys as tapped and
+      // consider this key as the next to be resolved.
+      for (uint8_t i = 0; i < num_tap_holds; ++i) {
+        tap_hold_t* t = &tap_holds[i];
+        if (t->state == STATE_UNSETTLED) {
+          if (!in_streak(t, keycode, record)) {
+            break;
+          }
+          settle_as_tap(t);
+          update_streak_timer(t->keycode, &t->record);
+          allow_eager_mods = false;
+        }
+      }
 #endif
-    return true;  // Otherwise, continue with default handling.
-  } else if (record->event.pressed && tap_hold_keycode != keycode) {
-    // Track whether another key was pressed while using a tap-hold key.
-    pressed_another_key_before_release = true;
-  }
 
-  // Release of the active tap-hold key.
-  if (keycode == tap_hold_keycode && !record->event.pressed) {
-    if (eager_mods) {
-      dprintln("Achordion: Key released. Clearing eager mods.");
-      tap_hold_record.event.pressed = false;
-      process_eager_mods_action();
-    } else if (achordion_state == STATE_HOLDING) {
-      dprintln("Achordion: Key released. Plumbing hold release.");
-      tap_hold_record.event.pressed = false;
-      // Plumb hold release event.
-      recursively_process_record(&tap_hold_record, STATE_RELEASED);
-    } else if (!pressed_another_key_before_release) {
-      // No other key was pressed between the press and release of the tap-hold
-      // key, plumb a hold press and then a release.
-      dprintln("Achordion: Key released. Plumbing hold press and release.");
-      recursively_process_record(&tap_hold_record, STATE_HOLDING);
-      tap_hold_record.event.pressed = false;
-      recursively_process_record(&tap_hold_record, STATE_RELEASED);
-    } else {
-      dprintln("Achordion: Key released.");
+      // Track this key along with any others that are still unsettled, so
+      // that rolls over several tap-hold keys are settled by the key that
+      // follows them. If the table is full, fall back to settling the
+      // pending keys as held below.
+      if (num_tap_holds < ACHORDION_MAX_PENDING) {
+        add_tap_hold(keycode, record, timeout, allow_eager_mods);
+        return false;  // Skip default handling.
+      }
     }
-
-    achordion_state = STATE_RELEASED;
-    tap_hold_keycode = KC_NO;
-    return false;
   }
 
-  if (achordion_state == STATE_UNSETTLED && record->event.pressed) {
-#ifdef ACHORDION_STREAK
-    const uint16_t s_timeout =
-        achordion_streak_chord_timeout(tap_hold_keycode, keycode);
-    const bool is_streak =
-        streak_timer && s_timeout &&
-        !timer_expired(record->event.time, (streak_timer + s_timeout));
-#endif
-
-    // Press event occurred on a key other than the active tap-hold key.
+  const uint8_t end = pending_end();
+  if (end > 0 && record->event.pressed) {
+    // Press event occurred on a key other than the tracked tap-hold keys.
 
     // If the other key is *also* a tap-hold key and considered by QMK to be
-    // held, then we settle the active key as held. This way, things like
-    // chording multiple home row modifiers will work, but let's our logic
-    // consider simply a single tap-hold key as "active" at a time.
+    // held, it either was added to the table above or the table is full. In
+    // the latter case, we settle the pending keys as held. Likewise for
+    // non-key events like combos.
     //
-    // Otherwise, we call `achordion_chord()` to determine whether to settle the
-    // tap-hold key as tapped vs. held. We implement the tap or hold by plumbing
-    // events back into the handling pipeline so that QMK features and other
-    // user code can see them. This is done by calling `process_record()`, which
-    // in turn calls most handlers including `process_record_user()`.
-    if (!is_streak &&
-        (!is_key_event || (is_tap_hold && record->tap.count == 0) ||
-         achordion_chord(tap_hold_keycode, &tap_hold_record, keycode,
-                         record))) {
-      settle_as_hold();
+    // Otherwise, we call `achordion_chord()` to determine for each pending
+    // key whether to settle it as tapped vs. held. We implement the tap or
+    // hold by plumbing events back into the handling pipeline so that QMK
+    // features and other user code can see them. This is done by calling
+    // `process_record()`, which in turn calls most handlers including
+    // `process_record_user()`.
+    const uint8_t settled = settle_pending(
+        end, keycode, record,
+        !is_key_event || (is_tap_hold && record->tap.count == 0));
 
 #ifdef REPEAT_KEY_ENABLE
-      // Edge case involving LT + Repeat Key: in a sequence of "LT down, other
-      // down" where "other" is on the other layer in the same position as
-      // Repeat or Alternate Repeat, the repeated keycode is set instead of the
-      // one on the switched-to layer. Here we correct that.
-      if (get_repeat_key_count() != 0 && IS_QK_LAYER_TAP(tap_hold_keycode)) {
-        record->keycode = KC_NO;  // Forget the repeated keycode.
-        clear_weak_mods();
-      }
+    // Edge case involving LT + Repeat Key: in a sequence of "LT down, other
+    // down" where "other" is on the other layer in the same position as
+    // Repeat or Alternate Repeat, the repeated keycode is set instead of the
+    // one on the switched-to layer. Here we correct that.
+    if (get_repeat_key_count() != 0 && (settled & SETTLED_LAYER_TAP_HOLD)) {
+      record->keycode = KC_NO;  // Forget the repeated keycode.
+      clear_weak_mods();
+    }
 #endif  // REPEAT_KEY_ENABLE
-    } else {
-      settle_as_tap();
-
 #ifdef ACHORDION_STREAK
+    if (settled & SETTLED_TAP) {
       update_streak_timer(keycode, record);
-      if (is_streak && is_key_event && is_tap_hold && record->tap.count == 0) {
-        // If we are in a streak and resolved the current tap-hold key as a tap
-        // consider the next tap-hold key as active to be resolved next.
-        update_streak_timer(tap_hold_keycode, &tap_hold_record);
-        const uint16_t timeout = achordion_timeout(keycode);
-        tap_hold_keycode = keycode;
-        tap_hold_record = *record;
-        hold_timer = record->event.time + timeout;
-        achordion_state = STATE_UNSETTLED;
-        pressed_another_key_before_release = false;
-        return false;
-      }
-#endif
     }
+#endif
+    (void)settled;  // Unused if neither of the above is enabled.
 
-    recursively_process_record(record, achordion_state);  // Re-process event.
-    return false;  // Block the original event.
+    enqueue_event(record, 0, 0);  // Re-process event after the plumbed ones.
+    return false;                 // Block the original event.
   }
 
 #ifdef ACHORDION_STREAK
   // update idle timer on regular keys event
   update_streak_timer(keycode, record);
 #endif
+
+  if (event_queue_size > 0) {
+    // Don't let this event overtake the events still in the queue.
+    enqueue_event(record, 0, 0);
+    return false;
+  }
   return true;
 }
 
 void achordion_task(void) {
-  if (achordion_state == STATE_UNSETTLED &&
-      timer_expired(timer_read(), hold_timer)) {
-    settle_as_hold();  // Timeout expired, settle the key as held.
+  // If a key's timeout expired, settle it and the keys pressed before it as
+  // held.
+  for (uint8_t end = num_tap_holds; end > 0; --end) {
+    const tap_hold_t* t = &tap_holds[end - 1];
+    if (t->state == STATE_UNSETTLED &&
+        timer_expired(timer_read(), t->hold_timer)) {
+      for (uint8_t i = 0; i < end; ++i) {
+        if (tap_holds[i].state == STATE_UNSETTLED) {
+          settle_as_hold(&tap_holds[i]);
+        }
+      }
+      break;
+    }
   }
 
+  replay_events();
+
 #ifdef ACHORDION_STREAK
 #define MAX_STREAK_TIMEOUT 800
   if (streak_timer &&
@@ -374,7 +556,13 @@ __attribute__((weak)) bool achordion_streak_continue(uint16_t keycode) {
 
 __attribute__((weak)) uint16_t achordion_streak_chord_timeout(
     uint16_t tap_hold_keycode, uint16_t next_keycode) {
+#ifdef ADAPTIVE_TERM_ENABLE
+  // Use the streak timeout learned from typing, once there are enough samples.
+  return adaptive_term_streak_timeout(
+      tap_hold_keycode, achordion_streak_timeout(tap_hold_keycode));
+#else
   return achordion_streak_timeout(tap_hold_keycode);
+#endif  // ADAPTIVE_TERM_ENABLE
 }
 
 __attribute__((weak)) uint16_t
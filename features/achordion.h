@@ -39,6 +39,17 @@
  * Achordion only changes the behavior when QMK considered the key held. It
  * changes some would-be holds to taps, but no taps to holds.
  *
+ * Several tap-hold keys may be unsettled at once, as when rolling over home
+ * row mods. Each has its own timeout and eager mods, and they are settled in
+ * the order they were pressed, each by `achordion_chord()` with the key that
+ * follows the roll. Up to `ACHORDION_MAX_PENDING` tap-hold keys are tracked,
+ * 4 by default. Beyond that, the pending keys are settled as held.
+ *
+ * The events that Achordion plumbs to settle keys are queued and replayed from
+ * `achordion_task()`, along with any events that come in while the queue is
+ * not empty, so that events stay in order. `ACHORDION_QUEUE_SIZE`, 16 by
+ * default, bounds the queue. Each settled tap takes up to three entries.
+ *
  * @note Some QMK features handle events before the point where Achordion can
  * intercept them, particularly: Combos, Key Lock, and Dynamic Macros. It's
  * still possible to use these features and Achordion in your keymap, but beware
@@ -57,6 +68,14 @@
 extern "C" {
 #endif
 
+#ifndef ACHORDION_MAX_PENDING
+#define ACHORDION_MAX_PENDING 4
+#endif  // ACHORDION_MAX_PENDING
+
+#ifndef ACHORDION_QUEUE_SIZE
+#define ACHORDION_QUEUE_SIZE 16
+#endif  // ACHORDION_QUEUE_SIZE
+
 /**
  * Handler function for Achordion.
  *
@@ -177,6 +196,9 @@ bool achordion_opposite_hands(const keyrecord_t* tap_hold_record,
  *        uint16_t tap_hold_keycode, uint16_t next_keycode) {
  *      return 200;  // Default of 200 ms.
  *    }
+ *
+ * With Adaptive Term enabled, the default timeout is the one it learns for
+ * the key from typing, see features/adaptive_term.h.
  */
 #ifdef ACHORDION_STREAK
 uint16_t achordion_streak_chord_timeout(uint16_t tap_hold_keycode,
@@ -0,0 +1,300 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file adaptive_term.c
+ * @brief Adaptive Term implementation
+ */
+
+#include "adaptive_term.h"
+
+#if !defined(EECONFIG_USER_DATA_SIZE) || \
+    EECONFIG_USER_DATA_SIZE < ADAPTIVE_TERM_EEPROM_SIZE
+#error "adaptive_term: Define EECONFIG_USER_DATA_SIZE >= ADAPTIVE_TERM_EEPROM_SIZE in config.h."
+#endif
+
+#if ADAPTIVE_TERM_NUM_BINS * ADAPTIVE_TERM_BIN_MS > 0xFFFF
+#error "adaptive_term: The histograms must span less than 65536 ms."
+#endif
+
+typedef struct {
+  uint16_t keycode;
+  adaptive_term_histograms_t histograms;
+} slot_t;
+
+// Layout of the EEPROM user data block. The bin parameters are saved so that
+// histograms with a different layout are discarded rather than misread.
+typedef struct {
+  uint8_t num_bins;
+  uint8_t bin_ms;
+  slot_t slots[ADAPTIVE_TERM_MAX_KEYS];
+} saved_t;
+
+_Static_assert(sizeof(saved_t) == ADAPTIVE_TERM_EEPROM_SIZE,
+               "adaptive_term: Unexpected padding in saved_t.");
+
+static saved_t data = {0};
+static uint8_t num_keys = 0;
+// Press times of the observed keys.
+static uint16_t press_time[ADAPTIVE_TERM_MAX_KEYS] = {0};
+// Whether another key was pressed while each observed key was down.
+static bool interrupted[ADAPTIVE_TERM_MAX_KEYS] = {0};
+// Default tapping term of each observed key, as last passed to
+// adaptive_term_tapping_term(), or 0 if not yet known.
+static uint16_t default_terms[ADAPTIVE_TERM_MAX_KEYS] = {0};
+// Time of the last key press, if `last_press_valid`.
+static uint16_t last_press_time = 0;
+static bool last_press_valid = false;
+// Whether the histograms changed since they were last saved.
+static bool dirty = false;
+
+static void save(void) {
+  eeconfig_update_user_datablock(&data, 0, sizeof(data));
+  dirty = false;
+}
+
+static void init(void) {
+  static bool initialized = false;
+  if (initialized) {
+    return;
+  }
+  initialized = true;
+
+  num_keys = NUM_ADAPTIVE_TERM_KEYS < ADAPTIVE_TERM_MAX_KEYS
+                 ? NUM_ADAPTIVE_TERM_KEYS
+                 : ADAPTIVE_TERM_MAX_KEYS;
+  for (uint8_t i = 0; i < num_keys; ++i) {
+    data.slots[i].keycode = adaptive_term_keys[i];
+  }
+  data.num_bins = ADAPTIVE_TERM_NUM_BINS;
+  data.bin_ms = ADAPTIVE_TERM_BIN_MS;
+
+  uint8_t header[2];
+  eeconfig_read_user_datablock(header, 0, sizeof(header));
+  if (header[0] != data.num_bins || header[1] != data.bin_ms) {
+    dprintln("Adaptive Term: No saved histograms.");
+    return;
+  }
+
+  // Load the saved histograms of each key, matching by keycode, so that they
+  // survive keys being added to or reordered in `adaptive_term_keys`.
+  for (uint8_t j = 0; j < ADAPTIVE_TERM_MAX_KEYS; ++j) {
+    const uint32_t offset = offsetof(saved_t, slots) + j * sizeof(slot_t);
+    uint16_t keycode;
+    eeconfig_read_user_datablock(&keycode, offset, sizeof(keycode));
+    for (uint8_t i = 0; i < num_keys; ++i) {
+      if (data.slots[i].keycode == keycode) {
+        eeconfig_read_user_datablock(&data.slots[i].histograms,
+                                     offset + offsetof(slot_t, histograms),
+                                     sizeof(adaptive_term_histograms_t));
+        break;
+      }
+    }
+  }
+}
+
+static int8_t find_key(uint16_t keycode) {
+  for (uint8_t i = 0; i < num_keys; ++i) {
+    if (data.slots[i].keycode == keycode) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+static void add_sample(uint8_t* histogram, uint16_t ms) {
+  uint8_t bin = ms / ADAPTIVE_TERM_BIN_MS;
+  if (bin >= ADAPTIVE_TERM_NUM_BINS) {
+    bin = ADAPTIVE_TERM_NUM_BINS - 1;
+  }
+  if (histogram[bin] == UINT8_MAX) {
+    // Halve all counts, which gradually forgets older samples.
+    for (uint8_t k = 0; k < ADAPTIVE_TERM_NUM_BINS; ++k) {
+      histogram[k] >>= 1;
+    }
+  }
+  ++histogram[bin];
+  dirty = true;
+}
+
+static uint16_t count_samples(const uint8_t* histogram) {
+  uint16_t total = 0;
+  for (uint8_t k = 0; k < ADAPTIVE_TERM_NUM_BINS; ++k) {
+    total += histogram[k];
+  }
+  return total;
+}
+
+// Returns the upper edge in ms of the bin containing the `percentile`th
+// percentile of the sum of histograms `a` and `b`, or 0 if there are too few
+// samples. `b` may be NULL.
+static uint16_t get_percentile(const uint8_t* a, const uint8_t* b,
+                               uint8_t percentile) {
+  const uint16_t total = count_samples(a) + (b ? count_samples(b) : 0);
+  if (total < ADAPTIVE_TERM_MIN_SAMPLES) {
+    return 0;
+  }
+  const uint32_t target = (uint32_t)total * percentile;
+  uint32_t sum = 0;
+  for (uint8_t k = 0; k < ADAPTIVE_TERM_NUM_BINS; ++k) {
+    sum += (uint32_t)(a[k] + (b ? b[k] : 0)) * 100;
+    if (sum >= target) {
+      return (k + 1) * ADAPTIVE_TERM_BIN_MS;
+    }
+  }
+  return ADAPTIVE_TERM_NUM_BINS * ADAPTIVE_TERM_BIN_MS;
+}
+
+void process_adaptive_term(uint16_t keycode, keyrecord_t* record) {
+  if (!IS_KEYEVENT(record->event)) {
+    return;
+  }
+  init();
+
+  const uint16_t time = record->event.time;
+  const int8_t i = find_key(keycode);
+  if (record->event.pressed) {
+    // This press interrupts any observed key that is down.
+    memset(interrupted, true, sizeof(interrupted));
+    if (i >= 0) {
+      press_time[i] = time;
+      interrupted[i] = false;
+      // QMK may process a tap-hold press after later events, so the interval
+      // might be "negative." Such intervals wrap to large values.
+      const uint16_t interval = time - last_press_time;
+      if (last_press_valid &&
+          interval < ADAPTIVE_TERM_NUM_BINS * ADAPTIVE_TERM_BIN_MS) {
+        add_sample(data.slots[i].histograms.interval, interval);
+      }
+    }
+    last_press_time = time;
+    last_press_valid = true;
+  } else if (i >= 0) {
+    const uint16_t duration = time - press_time[i];
+    if (record->tap.count > 0) {
+      add_sample(data.slots[i].histograms.tap, duration);
+    } else if (!interrupted[i]) {
+      // A hold with no other key pressed, like a mod-tap pressed and released
+      // alone, is most likely a tap held slightly too long, if released soon
+      // after the default tapping term. The learned term isn't used here, since
+      // each miss would widen the window for the next.
+      const uint16_t t = default_terms[i] ? default_terms[i] : TAPPING_TERM;
+      if (duration < t + ADAPTIVE_TERM_MISS_WINDOW) {
+        add_sample(data.slots[i].histograms.missed, duration);
+      }
+    }
+  }
+}
+
+void adaptive_term_task(void) {
+  init();
+
+  static uint32_t save_timer = 0;
+  if (dirty && timer_expired32(timer_read32(), save_timer)) {
+    if (save_timer) {  // Don't save right after boot.
+      dprintln("Adaptive Term: Saving histograms.");
+      save();
+    }
+    save_timer = timer_read32() + ADAPTIVE_TERM_SAVE_INTERVAL;
+  }
+
+#if ADAPTIVE_TERM_DUMP_INTERVAL > 0
+  static uint32_t dump_timer = 0;
+  if (timer_expired32(timer_read32(), dump_timer)) {
+    dump_timer = timer_read32() + ADAPTIVE_TERM_DUMP_INTERVAL;
+    if (debug_enable) {
+      adaptive_term_dump();
+    }
+  }
+#endif  // ADAPTIVE_TERM_DUMP_INTERVAL > 0
+}
+
+// Derives the tapping term from taps and missed taps together.
+static uint16_t derive_term(const adaptive_term_histograms_t* h,
+                            uint16_t default_term) {
+  const uint16_t p =
+      get_percentile(h->tap, h->missed, ADAPTIVE_TERM_TAP_PERCENTILE);
+  if (!p) {
+    return default_term;
+  }
+  const uint16_t t = p + ADAPTIVE_TERM_MARGIN;
+  return t < ADAPTIVE_TERM_MIN   ? ADAPTIVE_TERM_MIN
+         : t > ADAPTIVE_TERM_MAX ? ADAPTIVE_TERM_MAX
+                                 : t;
+}
+
+uint16_t adaptive_term_tapping_term(uint16_t keycode, uint16_t default_term) {
+  init();
+  const int8_t i = find_key(keycode);
+  if (i < 0) {
+    return default_term;
+  }
+  // Remember the default term, to recognize missed taps.
+  default_terms[i] = default_term;
+  return derive_term(&data.slots[i].histograms, default_term);
+}
+
+uint16_t adaptive_term_streak_timeout(uint16_t keycode,
+                                      uint16_t default_timeout) {
+  const adaptive_term_histograms_t* h = adaptive_term_get(keycode);
+  const uint16_t p =
+      h ? get_percentile(h->interval, NULL, ADAPTIVE_TERM_STREAK_PERCENTILE)
+        : 0;
+  return p ? p : default_timeout;
+}
+
+const adaptive_term_histograms_t* adaptive_term_get(uint16_t keycode) {
+  init();
+  const int8_t i = find_key(keycode);
+  return (i >= 0) ? &data.slots[i].histograms : NULL;
+}
+
+void adaptive_term_reset(void) {
+  init();
+  for (uint8_t i = 0; i < ADAPTIVE_TERM_MAX_KEYS; ++i) {
+    memset(&data.slots[i].histograms, 0, sizeof(adaptive_term_histograms_t));
+  }
+  save();
+}
+
+static void dump_histogram(const char* name, const uint8_t* histogram) {
+  xprintf("  %-4s", name);
+  for (uint8_t k = 0; k < ADAPTIVE_TERM_NUM_BINS; ++k) {
+    xprintf(" %3u", histogram[k]);
+  }
+  xprintf("\n");
+}
+
+void adaptive_term_dump(void) {
+  init();
+  xprintf("adaptive_term (bins of %u ms)\n", ADAPTIVE_TERM_BIN_MS);
+  xprintf("%-20s %6s %6s %6s %6s %6s\n", "key", "taps", "misses", "term",
+          "gaps", "streak");
+  for (uint8_t i = 0; i < num_keys; ++i) {
+    const uint16_t keycode = data.slots[i].keycode;
+    const adaptive_term_histograms_t* h = &data.slots[i].histograms;
+#ifdef KEYCODE_STRING_ENABLE
+    xprintf("%-20s", get_keycode_string(keycode));
+#else
+    xprintf("0x%04X              ", keycode);
+#endif  // KEYCODE_STRING_ENABLE
+    xprintf(" %6u %6u %6u %6u %6u\n", count_samples(h->tap),
+            count_samples(h->missed), derive_term(h, 0),
+            count_samples(h->interval),
+            adaptive_term_streak_timeout(keycode, 0));
+    dump_histogram("tap", h->tap);
+    dump_histogram("miss", h->missed);
+    dump_histogram("gap", h->interval);
+  }
+}
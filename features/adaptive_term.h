@@ -0,0 +1,216 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file adaptive_term.h
+ * @brief Adaptive Term, tap-hold timeouts learned from typing.
+ *
+ * Overview
+ * --------
+ *
+ * The right tapping term depends on how fast you type, and differs from key to
+ * key: pinkies are slower than index fingers. This library observes the
+ * tap-hold keys of the keymap as you type and derives a timeout per key:
+ *
+ *  * Tapping term: For each key, the durations from press to release of the
+ *    key's taps are collected in a histogram. Taps that were held past the
+ *    tapping term are settled as holds and never seen as taps, so a second
+ *    histogram collects missed taps: holds that no other key interrupted,
+ *    released within `ADAPTIVE_TERM_MISS_WINDOW` ms after the key's default
+ *    term. The tapping term is set a margin above the 95th percentile of both
+ *    histograms together, so that slow taps aren't mistaken for holds, and a
+ *    term that is too short grows as misses are observed. The window is fixed
+ *    rather than following the learned term, so that deliberate lone holds,
+ *    like holding a mod while clicking the mouse, can't ratchet the term up.
+ *
+ *  * Streak timeout: For each key, the intervals from the previous key press
+ *    to the key's press are collected likewise. The 90th percentile is the
+ *    typical gap between keys within a word, suitable for typing streak
+ *    timeouts such as `achordion_streak_chord_timeout()` or Flow Tap. With
+ *    `ACHORDION_STREAK`, Achordion's default `achordion_streak_chord_timeout()`
+ *    uses it, falling back to `achordion_streak_timeout()`.
+ *
+ * The histograms have `ADAPTIVE_TERM_NUM_BINS` bins of `ADAPTIVE_TERM_BIN_MS`
+ * milliseconds, 16 bins of 24 ms by default, with 8-bit counts. When a count
+ * would overflow, all counts of the histogram are halved, so that old samples
+ * are gradually forgotten. Until a histogram has `ADAPTIVE_TERM_MIN_SAMPLES`
+ * samples, the given default timeout is used.
+ *
+ * The histograms are persisted in the EEPROM user data block every
+ * `ADAPTIVE_TERM_SAVE_INTERVAL` milliseconds, 5 minutes by default, if they
+ * have changed. This needs `EECONFIG_USER_DATA_SIZE` of at least
+ * `ADAPTIVE_TERM_EEPROM_SIZE` bytes in config.h.
+ *
+ * Use
+ * ---
+ *
+ * Build with `ADAPTIVE_TERM_ENABLE = yes` in rules.mk. In keymap.c, list the
+ * tap-hold keys to observe, at most `ADAPTIVE_TERM_MAX_KEYS` (8 by default):
+ *
+ *     const uint16_t adaptive_term_keys[] = {HRM_A, HRM_S, HRM_D, HRM_F};
+ *     uint8_t NUM_ADAPTIVE_TERM_KEYS =
+ *         sizeof(adaptive_term_keys) / sizeof(*adaptive_term_keys);
+ *
+ * Call the handler and task from `process_record_user()` and
+ * `housekeeping_task_user()`, and use the derived tapping terms:
+ *
+ *     bool process_record_user(uint16_t keycode, keyrecord_t* record) {
+ *       process_adaptive_term(keycode, record);
+ *       // Your macros...
+ *     }
+ *
+ *     void housekeeping_task_user(void) {
+ *       adaptive_term_task();
+ *     }
+ *
+ *     uint16_t get_tapping_term(uint16_t keycode, keyrecord_t* record) {
+ *       return adaptive_term_tapping_term(keycode, TAPPING_TERM);
+ *     }
+ *
+ * With debug enabled, the histograms and derived timeouts are printed to the
+ * console every `ADAPTIVE_TERM_DUMP_INTERVAL` milliseconds, or only when
+ * calling `adaptive_term_dump()` if the interval is 0, the default.
+ */
+
+#pragma once
+
+#include "quantum.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef ADAPTIVE_TERM_MAX_KEYS
+#define ADAPTIVE_TERM_MAX_KEYS 8
+#endif  // ADAPTIVE_TERM_MAX_KEYS
+
+#ifndef ADAPTIVE_TERM_NUM_BINS
+#define ADAPTIVE_TERM_NUM_BINS 16
+#endif  // ADAPTIVE_TERM_NUM_BINS
+
+#ifndef ADAPTIVE_TERM_BIN_MS
+#define ADAPTIVE_TERM_BIN_MS 24
+#endif  // ADAPTIVE_TERM_BIN_MS
+
+#ifndef ADAPTIVE_TERM_MIN_SAMPLES
+#define ADAPTIVE_TERM_MIN_SAMPLES 32
+#endif  // ADAPTIVE_TERM_MIN_SAMPLES
+
+#ifndef ADAPTIVE_TERM_TAP_PERCENTILE
+#define ADAPTIVE_TERM_TAP_PERCENTILE 95
+#endif  // ADAPTIVE_TERM_TAP_PERCENTILE
+
+#ifndef ADAPTIVE_TERM_STREAK_PERCENTILE
+#define ADAPTIVE_TERM_STREAK_PERCENTILE 90
+#endif  // ADAPTIVE_TERM_STREAK_PERCENTILE
+
+// Added to the tap duration percentile to get the tapping term.
+#ifndef ADAPTIVE_TERM_MARGIN
+#define ADAPTIVE_TERM_MARGIN 25
+#endif  // ADAPTIVE_TERM_MARGIN
+
+// Bounds on the derived tapping terms.
+#ifndef ADAPTIVE_TERM_MIN
+#define ADAPTIVE_TERM_MIN 120
+#endif  // ADAPTIVE_TERM_MIN
+
+#ifndef ADAPTIVE_TERM_MAX
+#define ADAPTIVE_TERM_MAX 350
+#endif  // ADAPTIVE_TERM_MAX
+
+// How long after the default tapping term an uninterrupted hold may be released
+// to count as a missed tap.
+#ifndef ADAPTIVE_TERM_MISS_WINDOW
+#define ADAPTIVE_TERM_MISS_WINDOW 150
+#endif  // ADAPTIVE_TERM_MISS_WINDOW
+
+#ifndef ADAPTIVE_TERM_SAVE_INTERVAL
+#define ADAPTIVE_TERM_SAVE_INTERVAL 300000
+#endif  // ADAPTIVE_TERM_SAVE_INTERVAL
+
+#ifndef ADAPTIVE_TERM_DUMP_INTERVAL
+#define ADAPTIVE_TERM_DUMP_INTERVAL 0
+#endif  // ADAPTIVE_TERM_DUMP_INTERVAL
+
+/** Bytes of the EEPROM user data block used by Adaptive Term. */
+#define ADAPTIVE_TERM_EEPROM_SIZE \
+  (2 + ADAPTIVE_TERM_MAX_KEYS * (2 + 3 * ADAPTIVE_TERM_NUM_BINS))
+
+/** Histograms of a tap-hold key's timings. */
+typedef struct {
+  /** Durations from press to release of the key's taps. */
+  uint8_t tap[ADAPTIVE_TERM_NUM_BINS];
+  /** Durations from press to release of missed taps. */
+  uint8_t missed[ADAPTIVE_TERM_NUM_BINS];
+  /** Intervals from the previous key press to the key's press. */
+  uint8_t interval[ADAPTIVE_TERM_NUM_BINS];
+} adaptive_term_histograms_t;
+
+/** Tap-hold keys to observe, defined in keymap.c. */
+extern const uint16_t adaptive_term_keys[];
+/** Number of entries in `adaptive_term_keys`. */
+extern uint8_t NUM_ADAPTIVE_TERM_KEYS;
+
+/**
+ * Handler function for Adaptive Term.
+ *
+ * Call this from `process_record_user()`. It only observes events, so unlike
+ * most handlers, it has no return value.
+ */
+void process_adaptive_term(uint16_t keycode, keyrecord_t* record);
+
+/**
+ * Task function for Adaptive Term.
+ *
+ * Call this from `housekeeping_task_user()`. It periodically saves the
+ * histograms to EEPROM and, if enabled, prints them.
+ */
+void adaptive_term_task(void);
+
+/**
+ * Gets the tapping term derived for `keycode`.
+ *
+ * Call this from `get_tapping_term()`. Missed taps are recognized relative to
+ * `default_term`.
+ *
+ * @param keycode Keycode of the tap-hold key.
+ * @param default_term Term to return if the key has too few samples or isn't
+ *                     observed.
+ * @return Tapping term in milliseconds.
+ */
+uint16_t adaptive_term_tapping_term(uint16_t keycode, uint16_t default_term);
+
+/**
+ * Gets the typing streak timeout derived for `keycode`.
+ *
+ * @param keycode Keycode of the tap-hold key.
+ * @param default_timeout Timeout to return if the key has too few samples or
+ *                        isn't observed.
+ * @return Streak timeout in milliseconds.
+ */
+uint16_t adaptive_term_streak_timeout(uint16_t keycode,
+                                      uint16_t default_timeout);
+
+/** Gets the histograms of `keycode`, or NULL if it isn't observed. */
+const adaptive_term_histograms_t* adaptive_term_get(uint16_t keycode);
+
+/** Clears all histograms, also in EEPROM. */
+void adaptive_term_reset(void);
+
+/** Prints the histograms and derived timeouts to the console. */
+void adaptive_term_dump(void);
+
+#ifdef __cplusplus
+}
+#endif
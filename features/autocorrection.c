@@ -22,9 +22,8 @@
 
 #include "autocorrection.h"
 
-#include <string.h>
-
 #include "autocorrection_data.h"
+#include "keycode_class.h"
 
 #pragma message \
     "Autocorrect is now a core QMK feature! To use it, update your QMK set up and see https://docs.qmk.fm/features/autocorrect"
@@ -37,10 +36,195 @@
 #error "Min typo length is less than 4. Autocorrection may behave poorly."
 #endif
 
-bool process_autocorrection(uint16_t keycode, keyrecord_t* record) {
-  static uint8_t typo_buffer[AUTOCORRECTION_MAX_LENGTH] = {0};
-  static uint8_t typo_buffer_size = 0;
+// Bytes per node link and per string pool offset, 2 unless the generated data
+// says otherwise. 3-byte offsets allow tables beyond 64 KB.
+#ifndef AUTOCORRECTION_LINK_BYTES
+#define AUTOCORRECTION_LINK_BYTES 2
+#endif  // AUTOCORRECTION_LINK_BYTES
+#ifndef AUTOCORRECTION_STRING_POOL_BYTES
+#define AUTOCORRECTION_STRING_POOL_BYTES 2
+#endif  // AUTOCORRECTION_STRING_POOL_BYTES
+
+#if AUTOCORRECTION_LINK_BYTES == 3 || AUTOCORRECTION_STRING_POOL_BYTES == 3
+#ifdef __AVR__
+#error "autocorrection: The autocorrection data exceeds 64 KB, which is too large for AVR. Please reduce the dictionary."
+#endif  // __AVR__
+#define AUTOCORRECTION_OFFSET_24BIT
+typedef uint32_t autocorrection_offset_t;
+#else
+typedef uint16_t autocorrection_offset_t;
+#endif
+
+// Recently typed keys, kept in a ring buffer starting at `typo_buffer_head`.
+// They are only read back to rebuild the cursors after a backspace.
+static uint8_t typo_buffer[AUTOCORRECTION_MAX_LENGTH] = {0};
+static uint8_t typo_buffer_head = 0;
+static uint8_t typo_buffer_size = 0;
+// Live trie cursors, one per partial match of a typo against the end of the
+// buffer. Each is the trie state to advance with the next key: an offset in
+// `autocorrection_data`, or a double-array state. A partial match is shorter
+// than AUTOCORRECTION_MAX_LENGTH, so there are never more cursors than that.
+static autocorrection_offset_t cursors[AUTOCORRECTION_MAX_LENGTH] = {0};
+static uint8_t num_cursors = 0;
+
+static void clear_buffer(void) {
+  typo_buffer_size = 0;
+  num_cursors = 0;
+}
+
+// Gets the ith oldest key in the buffer.
+static uint8_t get_buffer_key(uint8_t i) {
+  i += typo_buffer_head;
+  return typo_buffer[i < AUTOCORRECTION_MAX_LENGTH
+                         ? i
+                         : i - AUTOCORRECTION_MAX_LENGTH];
+}
+
+// Appends `key` to the buffer, discarding the oldest key if it is full.
+static void push_buffer_key(uint8_t key) {
+  if (typo_buffer_size >= AUTOCORRECTION_MAX_LENGTH) {
+    if (++typo_buffer_head >= AUTOCORRECTION_MAX_LENGTH) {
+      typo_buffer_head = 0;
+    }
+    --typo_buffer_size;
+  }
+  uint8_t i = typo_buffer_head + typo_buffer_size++;
+  if (i >= AUTOCORRECTION_MAX_LENGTH) {
+    i -= AUTOCORRECTION_MAX_LENGTH;
+  }
+  typo_buffer[i] = key;
+}
+
+// Reads a little-endian offset of `num_bytes` bytes, 2 or 3, from PROGMEM.
+static autocorrection_offset_t read_offset(const uint8_t* p,
+                                          uint8_t num_bytes) {
+  autocorrection_offset_t offset = pgm_read_byte(p) | pgm_read_byte(p + 1) << 8;
+#ifdef AUTOCORRECTION_OFFSET_24BIT
+  if (num_bytes > 2) {
+    offset |= (uint32_t)pgm_read_byte(p + 2) << 16;
+  }
+#endif  // AUTOCORRECTION_OFFSET_24BIT
+  return offset;
+}
+
+// trie_step(state, key) advances a trie cursor at `state` by `key`. It returns
+// the new state, or 0 if `key` does not continue the match. (The root is state
+// 0 and is never reached by a step, so 0 is free to mean "no match".)
+#ifdef AUTOCORRECTION_DOUBLE_ARRAY
+// Decoder for the double-array trie, made with
+// `make_autocorrection_data.py --format=double-array`. The transition from
+// state s on symbol c goes to t = base[s] + c, provided that check[t] == s.
+
+#define DOUBLE_ARRAY_LEAF 0x8000
+#define DOUBLE_ARRAY_NUM_STATES \
+  (sizeof(autocorrection_check) / sizeof(*autocorrection_check))
+
+// Maps a key to its symbol. This must match DOUBLE_ARRAY_SYMBOLS in
+// make_autocorrection_data.py.
+static uint8_t key_to_symbol(uint8_t key) {
+  if (KC_A <= key && key <= KC_Z) {
+    return key - KC_A + 1;
+  }
+  return (key == KC_SPC) ? 27 : 28;  // Otherwise, key is KC_QUOT.
+}
+
+static autocorrection_offset_t trie_step(autocorrection_offset_t state,
+                                         uint8_t key) {
+  const uint16_t base = pgm_read_word(autocorrection_base + state);
+  if (base & DOUBLE_ARRAY_LEAF) {  // Leaves have no children.
+    return 0;
+  }
+  const uint16_t next = base + key_to_symbol(key);
+  if (next >= DOUBLE_ARRAY_NUM_STATES ||
+      pgm_read_word(autocorrection_check + next) != state) {
+    return 0;
+  }
+  return next;
+}
+
+// Gets the leaf data at `state`, or NULL if `state` is not a leaf.
+static const uint8_t* get_leaf(autocorrection_offset_t state) {
+  const uint16_t base = pgm_read_word(autocorrection_base + state);
+  return (base & DOUBLE_ARRAY_LEAF)
+             ? autocorrection_leaves + (base & ~DOUBLE_ARRAY_LEAF)
+             : NULL;
+}
+#else
+// Decoder for the byte-oriented trie.
+
+static autocorrection_offset_t trie_step(autocorrection_offset_t state,
+                                         uint8_t key) {
+  uint8_t code = pgm_read_byte(autocorrection_data + state);
+
+  if (code & 64) {  // Check for match in node with multiple children.
+    code &= 63;
+    for (; code != key;
+         code = pgm_read_byte(autocorrection_data +
+                              (state += 1 + AUTOCORRECTION_LINK_BYTES))) {
+      if (!code) {
+        return 0;
+      }
+    }
+
+    // Follow link to child node.
+    state = read_offset(autocorrection_data + state + 1,
+                        AUTOCORRECTION_LINK_BYTES);
+    // Otherwise check for match in node with a single child.
+  } else if (code != key) {
+    return 0;
+  } else if (!pgm_read_byte(autocorrection_data + (++state))) {
+    ++state;  // End of the chain, step over the terminator.
+  }
+
+  // Stop if `state` becomes an invalid index. This should not normally
+  // happen, it is a safeguard in case of a bug, data corruption, etc.
+  if (state >= sizeof(autocorrection_data)) {
+    return 0;
+  }
+  return state;
+}
+
+// Gets the leaf data at `state`, or NULL if `state` is not a leaf.
+static const uint8_t* get_leaf(autocorrection_offset_t state) {
+  return (pgm_read_byte(autocorrection_data + state) & 128)
+             ? autocorrection_data + state
+             : NULL;
+}
+#endif  // AUTOCORRECTION_DOUBLE_ARRAY
+
+// Advances all cursors by `key` and starts a new one at the root. Cursors that
+// fail to match are dropped. Returns the leaf data if a typo was completed, or
+// NULL otherwise. Since typos may not be substrings of one another, at most one
+// typo completes at a time.
+static const uint8_t* advance_cursors(uint8_t key) {
+  const uint8_t* leaf = NULL;
+  uint8_t n = 0;
+  for (uint8_t i = 0; i <= num_cursors; ++i) {
+    const autocorrection_offset_t state =
+        trie_step((i < num_cursors) ? cursors[i] : 0, key);
+    if (!state) {
+      continue;
+    }
+    const uint8_t* state_leaf = get_leaf(state);
+    if (state_leaf) {
+      leaf = state_leaf;
+    } else if (n < AUTOCORRECTION_MAX_LENGTH) {
+      cursors[n++] = state;
+    }
+  }
+  num_cursors = n;
+  return leaf;
+}
 
+// Rebuilds the cursors by replaying the buffer, e.g. after a backspace.
+static void rebuild_cursors(void) {
+  num_cursors = 0;
+  for (uint8_t i = 0; i < typo_buffer_size; ++i) {
+    advance_cursors(get_buffer_key(i));
+  }
+}
+
+bool process_autocorrection(uint16_t keycode, keyrecord_t* record) {
   // Ignore key release; we only process key presses.
   if (!record->event.pressed) {
     return true;
@@ -53,7 +237,7 @@ bool process_autocorrection(uint16_t keycode, keyrecord_t* record) {
 #endif  // NO_ACTION_ONESHOT
   // Disable autocorrection while a mod other than shift is active.
   if ((mods & ~MOD_MASK_SHIFT) != 0) {
-    typo_buffer_size = 0;
+    clear_buffer();
     return true;
   }
 
@@ -106,100 +290,60 @@ bool process_autocorrection(uint16_t keycode, keyrecord_t* record) {
       return true;  // Ignore these keys.
   }
 
-  if (keycode == KC_QUOT) {
+  const uint8_t flags = get_keycode_class(keycode);
+  if (flags & KEYCODE_CLASS_QUOTE) {
     // Treat " (shifted ') as a word boundary.
     if ((mods & MOD_MASK_SHIFT) != 0) {
       keycode = KC_SPC;
     }
-  } else if (!(KC_A <= keycode && keycode <= KC_Z)) {
+  } else if (!(flags & KEYCODE_CLASS_ALPHA)) {
     if (keycode == KC_BSPC) {
       // Remove last character from the buffer.
       if (typo_buffer_size > 0) {
         --typo_buffer_size;
+        rebuild_cursors();
       }
       return true;
-    } else if (KC_1 <= keycode && keycode <= KC_SLSH && keycode != KC_ESC) {
+    } else if (flags & KEYCODE_CLASS_WORD_BREAK) {
       // Set a word boundary if space, period, digit, etc. is pressed.
       // Behave more conservatively for the enter key. Reset, so that enter
       // can't be used on a word ending.
       if (keycode == KC_ENT) {
-        typo_buffer_size = 0;
+        clear_buffer();
       }
       keycode = KC_SPC;
     } else {
       // Clear state if some other non-alpha key is pressed.
-      typo_buffer_size = 0;
+      clear_buffer();
       return true;
     }
   }
 
-  // If the buffer is full, rotate it to discard the oldest character.
-  if (typo_buffer_size >= AUTOCORRECTION_MAX_LENGTH) {
-    memmove(typo_buffer, typo_buffer + 1, AUTOCORRECTION_MAX_LENGTH - 1);
-    typo_buffer_size = AUTOCORRECTION_MAX_LENGTH - 1;
-  }
-
-  // Append `keycode` to the buffer.
+  // Append `keycode` to the buffer and advance the partial matches.
   // NOTE: `keycode` must be a basic keycode (0-255) by this point.
-  typo_buffer[typo_buffer_size++] = (uint8_t)keycode;
-  // Early return if not many characters have been buffered so far.
-  if (typo_buffer_size < AUTOCORRECTION_MIN_LENGTH) {
-    return true;
-  }
+  push_buffer_key((uint8_t)keycode);
+  const uint8_t* leaf = advance_cursors((uint8_t)keycode);
 
-  // Check whether the buffer ends in a typo. This is done using a trie
-  // stored in `autocorrection_data`.
-  uint16_t state = 0;
-  uint8_t code = pgm_read_byte(autocorrection_data + state);
-  for (int i = typo_buffer_size - 1; i >= 0; --i) {
-    const uint8_t key_i = typo_buffer[i];
-
-    if (code & 64) {  // Check for match in node with multiple children.
-      code &= 63;
-      for (; code != key_i;
-           code = pgm_read_byte(autocorrection_data + (state += 3))) {
-        if (!code) {
-          return true;
-        }
-      }
-
-      // Follow link to child node.
-      state = (uint16_t)((uint_fast16_t)pgm_read_byte(autocorrection_data +
-                                                      state + 1) |
-                         (uint_fast16_t)pgm_read_byte(autocorrection_data +
-                                                      state + 2)
-                             << 8);
-      // Otherwise check for match in node with a single child.
-    } else if (code != key_i) {
-      return true;
-    } else if (!(code = pgm_read_byte(autocorrection_data + (++state)))) {
-      ++state;
+  if (leaf) {  // A typo was found! Apply autocorrection.
+    const int backspaces = pgm_read_byte(leaf) & 63;
+    for (int i = 0; i < backspaces; ++i) {
+      tap_code(KC_BSPC);
     }
+#ifdef AUTOCORRECTION_STRING_POOL
+    send_string_P((char const*)(autocorrection_strings +
+                                read_offset(leaf + 1,
+                                            AUTOCORRECTION_STRING_POOL_BYTES)));
+#else
+    send_string_P((char const*)(leaf + 1));
+#endif  // AUTOCORRECTION_STRING_POOL
 
-    // Stop if `state` becomes an invalid index. This should not normally
-    // happen, it is a safeguard in case of a bug, data corruption, etc.
-    if (state >= sizeof(autocorrection_data)) {
+    clear_buffer();
+    if (keycode == KC_SPC) {
+      push_buffer_key(KC_SPC);
+      advance_cursors(KC_SPC);
       return true;
-    }
-
-    // Read first byte of the next node.
-    code = pgm_read_byte(autocorrection_data + state);
-
-    if (code & 128) {  // A typo was found! Apply autocorrection.
-      const int backspaces = code & 63;
-      for (int i = 0; i < backspaces; ++i) {
-        tap_code(KC_BSPC);
-      }
-      send_string_P((char const*)(autocorrection_data + state + 1));
-
-      if (keycode == KC_SPC) {
-        typo_buffer[0] = KC_SPC;
-        typo_buffer_size = 1;
-        return true;
-      } else {
-        typo_buffer_size = 0;
-        return false;
-      }
+    } else {
+      return false;
     }
   }
 
@@ -71,12 +71,23 @@
  * script and run
  *
  *     $ python3 make_autocorrection_data.py
- *     Processed 71 autocorrection entries to table with 1120 bytes.
+ *     Processed 71 autocorrection entries to table with 1139 bytes.
  *
  * The script arranges the entries in autocorrection_dict.txt into a trie and
  * generates autocorrection_data.h with the serialized trie embedded as an
  * array. The .h file will be written in the same directory.
  *
+ * By default, the trie is serialized compactly, with the children of each node
+ * searched linearly. Passing `--format=double-array` to the script instead
+ * serializes it as a double-array trie, which takes more flash but looks up the
+ * next node in constant time per keypress. The script prints the sizes of both
+ * encodings to help decide.
+ *
+ * Large dictionaries: node links are 16-bit while the table fits in 64 KB, and
+ * switch to 24-bit automatically beyond that (ARM only; AVR can't address it).
+ * Passing `--string-pool` stores the corrections in a separate pool, in which a
+ * correction that is a suffix of another shares its storage.
+ *
  * Step 3: Finally, recompile and flash your keymap.
  *
  * For full documentation, see
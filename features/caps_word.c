@@ -22,6 +22,8 @@
 
 #include "caps_word.h"
 
+#include "keycode_class.h"
+
 #pragma message \
     "Caps Word is now a core QMK feature! To use it, update your QMK set up and see https://docs.qmk.fm/features/caps_word"
 
@@ -263,15 +265,18 @@ bool is_caps_word_on(void) { return caps_word_active; }
 __attribute__((weak)) void caps_word_set_user(bool active) {}
 
 __attribute__((weak)) bool caps_word_press_user(uint16_t keycode) {
-  switch (keycode) {
-    // Keycodes that continue Caps Word, with shift applied.
-    case KC_A ... KC_Z:
-    case KC_MINS:
-      add_weak_mods(MOD_BIT(KC_LSFT));  // Apply shift to the next key.
-      return true;
+  const uint8_t flags = get_keycode_class(keycode);
+  // Keycodes that continue Caps Word, with shift applied.
+  if ((flags & KEYCODE_CLASS_ALPHA) || keycode == KC_MINS) {
+    add_weak_mods(MOD_BIT(KC_LSFT));  // Apply shift to the next key.
+    return true;
+  }
 
-    // Keycodes that continue Caps Word, without shifting.
-    case KC_1 ... KC_0:
+  // Keycodes that continue Caps Word, without shifting.
+  if (flags & KEYCODE_CLASS_DIGIT) {
+    return true;
+  }
+  switch (keycode) {
     case KC_BSPC:
     case KC_DEL:
     case KC_UNDS:
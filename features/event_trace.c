@@ -0,0 +1,185 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file event_trace.c
+ * @brief Event Trace implementation
+ */
+
+#include "event_trace.h"
+
+#if defined(EVENT_TRACE_RAW_HID) && defined(RAW_ENABLE)
+#include "raw_hid.h"
+#define EVENT_TRACE_USE_RAW_HID
+#endif
+
+#if EVENT_TRACE_SIZE < 2 || EVENT_TRACE_SIZE > 128 || \
+    (EVENT_TRACE_SIZE & (EVENT_TRACE_SIZE - 1)) != 0
+#error "event_trace: EVENT_TRACE_SIZE must be a power of 2 from 2 to 128."
+#endif
+
+_Static_assert(sizeof(event_trace_record_t) == EVENT_TRACE_RECORD_SIZE,
+               "event_trace: Unexpected padding in event_trace_record_t.");
+
+#define INDEX_MASK (EVENT_TRACE_SIZE - 1)
+
+// Ring buffer of records. The indices count up freely and are masked on
+// access, so that `head - tail` is the number of records in the buffer.
+static event_trace_record_t records[EVENT_TRACE_SIZE];
+static uint8_t head = 0;
+static uint8_t tail = 0;
+// Number of events dropped since the buffer was last full.
+static uint16_t num_dropped = 0;
+// Event time of the last recorded event, and the timer when it was recorded.
+static uint16_t last_time = 0;
+static uint32_t last_record_timer = 0;
+static bool last_time_valid = false;
+
+static uint8_t buffer_count(void) { return (uint8_t)(head - tail); }
+
+static bool push(const event_trace_record_t* record) {
+  // A slot is kept for the dropped events record.
+  if (buffer_count() >= EVENT_TRACE_SIZE - (num_dropped ? 1 : 0)) {
+    return false;
+  }
+  records[head++ & INDEX_MASK] = *record;
+  return true;
+}
+
+void process_event_trace(uint16_t keycode, keyrecord_t* record) {
+  if (!debug_enable) {
+    return;
+  }
+
+  if (num_dropped && buffer_count() < EVENT_TRACE_SIZE) {
+    // There is room again, so report how many events were dropped.
+    const event_trace_record_t dropped = {
+        .flags = EVENT_TRACE_FLAG_DROPPED,
+        .keycode = num_dropped,
+    };
+    records[head++ & INDEX_MASK] = dropped;
+    num_dropped = 0;
+  }
+
+  const uint16_t time = record->event.time;
+  uint8_t flags = record->event.pressed ? EVENT_TRACE_FLAG_PRESSED : 0;
+  if (IS_QK_MOD_TAP(keycode) || IS_QK_LAYER_TAP(keycode)) {
+    flags |= EVENT_TRACE_FLAG_TAP_HOLD;
+  }
+#ifndef NO_ACTION_TAPPING
+  if (record->tap.count) {
+    flags |= EVENT_TRACE_FLAG_TAP;
+  }
+#endif  // NO_ACTION_TAPPING
+  if (IS_COMBOEVENT(record->event)) {
+    flags |= EVENT_TRACE_FLAG_COMBO;
+  }
+
+  // QMK may process a tap-hold press after later events, so the delta may be
+  // negative. After a long idle, it saturates instead of wrapping.
+  int16_t delta_ms = 0;
+  if (last_time_valid) {
+    delta_ms = timer_elapsed32(last_record_timer) < INT16_MAX
+                   ? (int16_t)(time - last_time)
+                   : INT16_MAX;
+  }
+
+  const event_trace_record_t entry = {
+      .delta_ms = delta_ms,
+      .row = record->event.key.row,
+      .col = record->event.key.col,
+      .layer = read_source_layers_cache(record->event.key),
+      .flags = flags,
+      .keycode = keycode,
+  };
+  if (push(&entry)) {
+    last_time = time;
+    last_record_timer = timer_read32();
+    last_time_valid = true;
+  } else if (num_dropped < UINT16_MAX) {
+    ++num_dropped;
+  }
+}
+
+bool event_trace_pop(event_trace_record_t* record) {
+  if (head == tail) {
+    return false;
+  }
+  *record = records[tail++ & INDEX_MASK];
+  return true;
+}
+
+void event_trace_serialize(const event_trace_record_t* record, uint8_t* dest) {
+  dest[0] = (uint8_t)record->delta_ms;
+  dest[1] = (uint8_t)((uint16_t)record->delta_ms >> 8);
+  dest[2] = record->row;
+  dest[3] = record->col;
+  dest[4] = record->layer;
+  dest[5] = record->flags;
+  dest[6] = (uint8_t)record->keycode;
+  dest[7] = (uint8_t)(record->keycode >> 8);
+}
+
+void event_trace_deserialize(const uint8_t* src, event_trace_record_t* record) {
+  record->delta_ms = (int16_t)(src[0] | (uint16_t)src[1] << 8);
+  record->row = src[2];
+  record->col = src[3];
+  record->layer = src[4];
+  record->flags = src[5];
+  record->keycode = src[6] | (uint16_t)src[7] << 8;
+}
+
+#ifdef EVENT_TRACE_USE_RAW_HID
+static void drain(void) {
+  uint8_t report[RAW_EPSIZE] = {EVENT_TRACE_RAW_HID_ID};
+  const uint8_t capacity = (RAW_EPSIZE - 2) / EVENT_TRACE_RECORD_SIZE;
+  uint8_t n = 0;
+  event_trace_record_t record;
+  while (n < capacity && event_trace_pop(&record)) {
+    event_trace_serialize(&record, report + 2 + n * EVENT_TRACE_RECORD_SIZE);
+    ++n;
+  }
+  if (n) {
+    report[1] = n;
+    raw_hid_send(report, sizeof(report));
+  }
+}
+#else
+static void drain(void) {
+  static const char hex_digits[] PROGMEM = "0123456789ABCDEF";
+  event_trace_record_t record;
+  for (uint8_t n = 0; n < EVENT_TRACE_DRAIN_RECORDS && event_trace_pop(&record);
+       ++n) {
+    uint8_t bytes[EVENT_TRACE_RECORD_SIZE];
+    event_trace_serialize(&record, bytes);
+    // Write "ET" and the bytes in hex directly, without printf formatting.
+    sendchar('E');
+    sendchar('T');
+    for (uint8_t i = 0; i < EVENT_TRACE_RECORD_SIZE; ++i) {
+      sendchar(pgm_read_byte(hex_digits + (bytes[i] >> 4)));
+      sendchar(pgm_read_byte(hex_digits + (bytes[i] & 15)));
+    }
+    sendchar('\n');
+  }
+}
+#endif  // EVENT_TRACE_USE_RAW_HID
+
+void event_trace_task(void) {
+  static uint16_t drain_timer = 0;
+  if (head != tail &&
+      timer_elapsed(drain_timer) >= EVENT_TRACE_DRAIN_INTERVAL) {
+    drain_timer = timer_read();
+    drain();
+  }
+}
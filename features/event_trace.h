@@ -0,0 +1,162 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file event_trace.h
+ * @brief Event Trace, compact binary logging of key events.
+ *
+ * Overview
+ * --------
+ *
+ * Logging every key event as text, as `dlog_record()` does, costs several
+ * `xprintf()` calls and keycode formatting per event, which stalls the USB
+ * console when typing fast. This library instead records each event as a
+ * fixed 8-byte record in a RAM ring buffer of `EVENT_TRACE_SIZE` records, 32
+ * by default. A low-priority task drains the buffer a little at a time, and a
+ * host-side decoder pretty-prints the records offline.
+ *
+ * Each record holds, in little endian:
+ *
+ *     bytes 0-1  Signed milliseconds since the previous record.
+ *     byte  2    Matrix row.
+ *     byte  3    Matrix column.
+ *     byte  4    Layer.
+ *     byte  5    Flags, `EVENT_TRACE_FLAG_*`.
+ *     bytes 6-7  Keycode.
+ *
+ * The time delta is negative when QMK settles a tap-hold key after processing
+ * later events, and saturates at 32767 after a long idle.
+ *
+ * If the buffer fills up, further events are dropped and counted. Once there
+ * is room, a record with `EVENT_TRACE_FLAG_DROPPED` is written, whose keycode
+ * field is the number of events dropped.
+ *
+ * The records are sent to the console by default, one per line as "ET"
+ * followed by 16 hex digits. Alternatively with `RAW_ENABLE = yes` and
+ * `EVENT_TRACE_RAW_HID` defined in config.h, they are sent as raw HID reports
+ * of `RAW_EPSIZE` bytes: the byte `EVENT_TRACE_RAW_HID_ID`, the number of
+ * records, then the records.
+ *
+ * Use
+ * ---
+ *
+ * Build with `EVENT_TRACE_ENABLE = yes` in rules.mk, or
+ *
+ *     qmk compile -kb zsa/voyager -km anarion -e EVENT_TRACE_ENABLE=yes
+ *
+ * Then call the handler and task from `process_record_user()` and
+ * `housekeeping_task_user()`:
+ *
+ *     bool process_record_user(uint16_t keycode, keyrecord_t* record) {
+ *       process_event_trace(keycode, record);
+ *       // Your macros...
+ *     }
+ *
+ *     void housekeeping_task_user(void) {
+ *       event_trace_task();
+ *     }
+ *
+ * Events are recorded while debug is enabled. To decode a console capture,
+ * build tools/host_sim and run
+ *
+ *     hid_listen | tools/host_sim/trace_decode
+ */
+
+#pragma once
+
+#include "quantum.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Number of records in the ring buffer, a power of 2. */
+#ifndef EVENT_TRACE_SIZE
+#define EVENT_TRACE_SIZE 32
+#endif  // EVENT_TRACE_SIZE
+
+/** Milliseconds between draining records from the buffer. */
+#ifndef EVENT_TRACE_DRAIN_INTERVAL
+#define EVENT_TRACE_DRAIN_INTERVAL 5
+#endif  // EVENT_TRACE_DRAIN_INTERVAL
+
+/** Maximum number of records sent to the console per drain. */
+#ifndef EVENT_TRACE_DRAIN_RECORDS
+#define EVENT_TRACE_DRAIN_RECORDS 2
+#endif  // EVENT_TRACE_DRAIN_RECORDS
+
+/** First byte of raw HID reports carrying records. */
+#ifndef EVENT_TRACE_RAW_HID_ID
+#define EVENT_TRACE_RAW_HID_ID 0xE7
+#endif  // EVENT_TRACE_RAW_HID_ID
+
+/** Size of a serialized record in bytes. */
+#define EVENT_TRACE_RECORD_SIZE 8
+
+/** The key was pressed, otherwise released. */
+#define EVENT_TRACE_FLAG_PRESSED 0x01
+/** The key is a mod-tap or layer-tap key. */
+#define EVENT_TRACE_FLAG_TAP_HOLD 0x02
+/** The event is a tap, `record->tap.count > 0`. */
+#define EVENT_TRACE_FLAG_TAP 0x04
+/** The event is from a combo, so row and column are meaningless. */
+#define EVENT_TRACE_FLAG_COMBO 0x08
+/** Events were dropped, as many as the keycode field. */
+#define EVENT_TRACE_FLAG_DROPPED 0x80
+
+/** One traced key event. */
+typedef struct {
+  int16_t delta_ms;
+  uint8_t row;
+  uint8_t col;
+  uint8_t layer;
+  uint8_t flags;
+  uint16_t keycode;
+} event_trace_record_t;
+
+/**
+ * Handler function for Event Trace.
+ *
+ * Call this from `process_record_user()`. It only observes events, so unlike
+ * most handlers, it has no return value.
+ */
+void process_event_trace(uint16_t keycode, keyrecord_t* record);
+
+/**
+ * Task function for Event Trace.
+ *
+ * Call this from `housekeeping_task_user()`. Every `EVENT_TRACE_DRAIN_INTERVAL`
+ * milliseconds, it sends a few records to the console or raw HID.
+ */
+void event_trace_task(void);
+
+/**
+ * Removes the oldest record from the buffer.
+ *
+ * For sending the records over a custom transport instead of the task.
+ *
+ * @param record Record to fill in.
+ * @return Whether a record was removed, false if the buffer is empty.
+ */
+bool event_trace_pop(event_trace_record_t* record);
+
+/** Serializes `record` as `EVENT_TRACE_RECORD_SIZE` bytes to `dest`. */
+void event_trace_serialize(const event_trace_record_t* record, uint8_t* dest);
+
+/** Parses a record serialized by `event_trace_serialize()`. */
+void event_trace_deserialize(const uint8_t* src, event_trace_record_t* record);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,171 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file handler_profile.c
+ * @brief Handler Profile implementation
+ */
+
+#include "handler_profile.h"
+
+#if defined(__CHIBIOS__) && \
+    (defined(__ARM_ARCH_7M__) || defined(__ARM_ARCH_7EM__))
+#define HANDLER_PROFILE_DWT
+#endif
+
+static handler_profile_stats_t stats[HANDLER_PROFILE_NUM_SLOTS] = {0};
+// Cost of an empty measurement, subtracted from every measurement.
+static uint32_t overhead = 0;
+
+static const char* const names[HANDLER_PROFILE_NUM_SLOTS] = {
+    [HANDLER_PROFILE_USER] = "process_record_user",
+    [HANDLER_PROFILE_CAPS_WORD] = "caps_word",
+    [HANDLER_PROFILE_SENTENCE_CASE] = "sentence_case",
+    [HANDLER_PROFILE_SELECT_WORD] = "select_word",
+    [HANDLER_PROFILE_CUSTOM_SHIFT_KEYS] = "custom_shift_keys",
+    [HANDLER_PROFILE_LAYER_LOCK] = "layer_lock",
+    [HANDLER_PROFILE_REPEAT_KEY] = "repeat_key",
+    [HANDLER_PROFILE_AUTOCORRECT] = "autocorrect",
+    [HANDLER_PROFILE_KEYMAP_0] = "keymap 0",
+    [HANDLER_PROFILE_KEYMAP_1] = "keymap 1",
+    [HANDLER_PROFILE_KEYMAP_2] = "keymap 2",
+    [HANDLER_PROFILE_KEYMAP_3] = "keymap 3",
+};
+
+#ifdef HANDLER_PROFILE_DWT
+static void counter_init(void) {
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+#if defined(__ARM_ARCH_7EM__) && defined(DWT_LAR_UNLOCK_KEY)
+  DWT->LAR = DWT_LAR_UNLOCK_KEY;  // Cortex-M7 locks the DWT by default.
+#endif
+  DWT->CYCCNT = 0;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+__attribute__((weak)) uint32_t handler_profile_cycles(void) {
+  return DWT->CYCCNT;
+}
+#else
+static void counter_init(void) {}
+
+__attribute__((weak)) uint32_t handler_profile_cycles(void) {
+  return timer_read32();
+}
+#endif  // HANDLER_PROFILE_DWT
+
+static void init(void) {
+  static bool initialized = false;
+  if (initialized) {
+    return;
+  }
+  initialized = true;
+  counter_init();
+
+  // Calibrate: the smallest of a few empty measurements is the overhead.
+  overhead = UINT32_MAX;
+  for (uint8_t i = 0; i < 8; ++i) {
+    const uint32_t start = handler_profile_cycles();
+    const uint32_t cycles = handler_profile_cycles() - start;
+    if (cycles < overhead) {
+      overhead = cycles;
+    }
+  }
+}
+
+void handler_profile_add(uint8_t id, uint32_t cycles) {
+  if (id >= HANDLER_PROFILE_NUM_SLOTS) {
+    return;
+  }
+  cycles = (cycles > overhead) ? cycles - overhead : 0;
+  handler_profile_stats_t* s = &stats[id];
+  if (s->count == 0 || cycles < s->min) {
+    s->min = cycles;
+  }
+  if (cycles > s->max) {
+    s->max = cycles;
+  }
+  s->total += cycles;
+  ++s->count;
+}
+
+const handler_profile_stats_t* handler_profile_get(uint8_t id) {
+  return (id < HANDLER_PROFILE_NUM_SLOTS) ? &stats[id] : NULL;
+}
+
+void handler_profile_reset(void) { memset(stats, 0, sizeof(stats)); }
+
+void handler_profile_dump(void) {
+#ifdef HANDLER_PROFILE_DWT
+  xprintf("handler_profile (cycles)\n");
+#else
+  xprintf("handler_profile (ms)\n");
+#endif  // HANDLER_PROFILE_DWT
+  xprintf("%-20s %8s %8s %8s %8s\n", "handler", "calls", "min", "mean", "max");
+  for (uint8_t id = 0; id < HANDLER_PROFILE_NUM_SLOTS; ++id) {
+    const handler_profile_stats_t* s = &stats[id];
+    if (s->count == 0) {
+      continue;
+    }
+    xprintf("%-20s %8lu %8lu %8lu %8lu\n", names[id], (unsigned long)s->count,
+            (unsigned long)s->min, (unsigned long)(s->total / s->count),
+            (unsigned long)s->max);
+  }
+}
+
+void handler_profile_task(void) {
+  init();
+#if HANDLER_PROFILE_DUMP_INTERVAL > 0
+  static uint32_t dump_timer = 0;
+  if (timer_expired32(timer_read32(), dump_timer)) {
+    dump_timer = timer_read32() + HANDLER_PROFILE_DUMP_INTERVAL;
+    if (debug_enable) {
+      handler_profile_dump();
+    }
+  }
+#endif  // HANDLER_PROFILE_DUMP_INTERVAL > 0
+}
+
+// Wrappers for handlers in QMK core and community modules, substituted by
+// passing `-Wl,--wrap=<name>` to the linker (see rules.mk). Each is defined
+// only if the handler is in the build, since `__real_<name>` must resolve.
+#define HANDLER_PROFILE_WRAP(id, name)                          \
+  bool __real_##name(uint16_t keycode, keyrecord_t* record);    \
+  bool __wrap_##name(uint16_t keycode, keyrecord_t* record);    \
+  bool __wrap_##name(uint16_t keycode, keyrecord_t* record) {   \
+    return HANDLER_PROFILE(id, __real_##name(keycode, record)); \
+  }
+
+#ifdef CAPS_WORD_ENABLE
+HANDLER_PROFILE_WRAP(HANDLER_PROFILE_CAPS_WORD, process_caps_word)
+#endif  // CAPS_WORD_ENABLE
+#ifdef LAYER_LOCK_ENABLE
+HANDLER_PROFILE_WRAP(HANDLER_PROFILE_LAYER_LOCK, process_layer_lock)
+#endif  // LAYER_LOCK_ENABLE
+#ifdef REPEAT_KEY_ENABLE
+HANDLER_PROFILE_WRAP(HANDLER_PROFILE_REPEAT_KEY, process_repeat_key)
+#endif  // REPEAT_KEY_ENABLE
+#ifdef AUTOCORRECT_ENABLE
+HANDLER_PROFILE_WRAP(HANDLER_PROFILE_AUTOCORRECT, process_autocorrect)
+#endif  // AUTOCORRECT_ENABLE
+#ifdef COMMUNITY_MODULE_SENTENCE_CASE_ENABLE
+HANDLER_PROFILE_WRAP(HANDLER_PROFILE_SENTENCE_CASE,
+                     process_record_sentence_case)
+#endif  // COMMUNITY_MODULE_SENTENCE_CASE_ENABLE
+#ifdef COMMUNITY_MODULE_SELECT_WORD_ENABLE
+HANDLER_PROFILE_WRAP(HANDLER_PROFILE_SELECT_WORD, process_record_select_word)
+#endif  // COMMUNITY_MODULE_SELECT_WORD_ENABLE
+#ifdef COMMUNITY_MODULE_CUSTOM_SHIFT_KEYS_ENABLE
+HANDLER_PROFILE_WRAP(HANDLER_PROFILE_CUSTOM_SHIFT_KEYS,
+                     process_record_custom_shift_keys)
+#endif  // COMMUNITY_MODULE_CUSTOM_SHIFT_KEYS_ENABLE
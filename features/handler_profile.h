@@ -0,0 +1,166 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file handler_profile.h
+ * @brief Handler Profile, per-handler latency measurement.
+ *
+ * Overview
+ * --------
+ *
+ * Every key event runs through a chain of handlers: `process_record_user()`,
+ * Caps Word, Sentence Case, Select Word, Custom Shift Keys, Layer Lock, Repeat
+ * Key, and so on. This library measures how long each of them takes. For each
+ * handler, it accumulates the number of calls and the min, max, and mean
+ * duration in a fixed-size table in RAM, which is periodically printed to the
+ * console.
+ *
+ * Durations are measured in CPU cycles with the DWT cycle counter on ARM
+ * Cortex-M3, M4, and M7 under ChibiOS. Elsewhere, the fallback is
+ * `timer_read32()`, whose 1 ms resolution is only good for spotting outliers.
+ * The counter may be replaced by defining `handler_profile_cycles()`.
+ *
+ * Use
+ * ---
+ *
+ * Profiling is opt-in. Build with
+ *
+ *     qmk compile -kb zsa/voyager -km anarion -e HANDLER_PROFILE_ENABLE=yes
+ *
+ * and set `CONSOLE_ENABLE = yes` to see the output. With that, rules.mk adds
+ * features/handler_profile.c to the build and wraps the handlers listed in
+ * `HANDLER_PROFILE_WRAPPED` with the linker's `--wrap` option, so neither QMK
+ * core nor the community modules need patching. Link-time wrapping does not
+ * work through LTO, so LTO is disabled in profiling builds.
+ *
+ * Handlers called directly from the keymap are timed with `HANDLER_PROFILE()`
+ * or `HANDLER_PROFILE_SCOPE()` instead:
+ *
+ *     bool process_record_user(uint16_t keycode, keyrecord_t* record) {
+ *       HANDLER_PROFILE_SCOPE(HANDLER_PROFILE_USER);
+ *       // Macros...
+ *     }
+ *
+ * Both expand to nothing when profiling is disabled. Then call
+ * `handler_profile_task()` from `housekeeping_task_user()`. With debug enabled,
+ * it prints the table every `HANDLER_PROFILE_DUMP_INTERVAL` milliseconds,
+ * 10000 by default. Set the interval to 0 to only print when calling
+ * `handler_profile_dump()`.
+ */
+
+#pragma once
+
+#include "quantum.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef HANDLER_PROFILE_DUMP_INTERVAL
+#define HANDLER_PROFILE_DUMP_INTERVAL 10000
+#endif  // HANDLER_PROFILE_DUMP_INTERVAL
+
+/** Handlers with a slot in the profile table. */
+enum handler_profile_id {
+  HANDLER_PROFILE_USER,
+  HANDLER_PROFILE_CAPS_WORD,
+  HANDLER_PROFILE_SENTENCE_CASE,
+  HANDLER_PROFILE_SELECT_WORD,
+  HANDLER_PROFILE_CUSTOM_SHIFT_KEYS,
+  HANDLER_PROFILE_LAYER_LOCK,
+  HANDLER_PROFILE_REPEAT_KEY,
+  HANDLER_PROFILE_AUTOCORRECT,
+  /** Slots from here on may be used freely by the keymap. */
+  HANDLER_PROFILE_KEYMAP_0,
+  HANDLER_PROFILE_KEYMAP_1,
+  HANDLER_PROFILE_KEYMAP_2,
+  HANDLER_PROFILE_KEYMAP_3,
+  HANDLER_PROFILE_NUM_SLOTS,
+};
+
+/** Accumulated statistics for one handler. */
+typedef struct {
+  uint32_t count;
+  uint32_t min;
+  uint32_t max;
+  uint64_t total;
+} handler_profile_stats_t;
+
+/**
+ * Reads the cycle counter.
+ *
+ * Only differences between readings are meaningful. Wraparound is fine as long
+ * as a single handler call is shorter than one period of the counter.
+ */
+uint32_t handler_profile_cycles(void);
+
+/** Adds a measurement of `cycles` for handler `id`. */
+void handler_profile_add(uint8_t id, uint32_t cycles);
+
+/** Gets the accumulated statistics for handler `id`. */
+const handler_profile_stats_t* handler_profile_get(uint8_t id);
+
+/** Clears all accumulated statistics. */
+void handler_profile_reset(void);
+
+/** Prints the table of accumulated statistics to the console. */
+void handler_profile_dump(void);
+
+/**
+ * Task function for Handler Profile.
+ *
+ * Call this from `housekeeping_task_user()`. It starts the cycle counter and,
+ * if debug is enabled, periodically prints the table.
+ */
+void handler_profile_task(void);
+
+/** @internal Helper for HANDLER_PROFILE_SCOPE(). */
+typedef struct {
+  uint8_t id;
+  uint32_t start;
+} handler_profile_scope_t;
+
+/** @internal Helper for HANDLER_PROFILE_SCOPE(). */
+static inline void handler_profile_scope_end(handler_profile_scope_t* scope) {
+  handler_profile_add(scope->id, handler_profile_cycles() - scope->start);
+}
+
+#ifdef HANDLER_PROFILE_ENABLE
+/**
+ * Evaluates the bool expression `call` and records how long it took:
+ *
+ *     if (!HANDLER_PROFILE(HANDLER_PROFILE_KEYMAP_0,
+ *                          process_foo(keycode, record))) { return false; }
+ */
+#define HANDLER_PROFILE(id, call)                                    \
+  ({                                                                 \
+    const uint32_t hp_start_ = handler_profile_cycles();             \
+    const bool hp_result_ = (call);                                  \
+    handler_profile_add((id), handler_profile_cycles() - hp_start_); \
+    hp_result_;                                                      \
+  })
+
+/** Records the time from here until the enclosing scope exits. */
+#define HANDLER_PROFILE_SCOPE(id)                             \
+  handler_profile_scope_t handler_profile_scope_              \
+      __attribute__((cleanup(handler_profile_scope_end))) = { \
+          (id), handler_profile_cycles()}
+#else
+#define HANDLER_PROFILE(id, call) (call)
+#define HANDLER_PROFILE_SCOPE(id)
+#endif  // HANDLER_PROFILE_ENABLE
+
+#ifdef __cplusplus
+}
+#endif
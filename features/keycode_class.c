@@ -0,0 +1,65 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file keycode_class.c
+ * @brief Keycode classification table implementation
+ */
+
+#include "keycode_class.h"
+
+#define ALPHA KEYCODE_CLASS_ALPHA
+#define DIGIT KEYCODE_CLASS_DIGIT
+#define SYMBOL KEYCODE_CLASS_SYMBOL
+#define ENDING KEYCODE_CLASS_ENDING
+#define SHIFTED_ENDING KEYCODE_CLASS_SHIFTED_ENDING
+#define QUOTE KEYCODE_CLASS_QUOTE
+#define SPACE KEYCODE_CLASS_SPACE
+#define WORD_BREAK KEYCODE_CLASS_WORD_BREAK
+
+// The table is generated at compile time with range designators. Keys not
+// listed, like modifiers, navigation, and function keys, have no flags.
+// clang-format off
+const uint8_t keycode_class_table[256] PROGMEM = {
+    [KC_A ... KC_Z]       = ALPHA,
+    [KC_1]                = DIGIT | SYMBOL | SHIFTED_ENDING | WORD_BREAK,  // 1 !
+    [KC_2 ... KC_0]       = DIGIT | SYMBOL | WORD_BREAK,  // 2 @ ... 0 )
+    [KC_ENT]              = WORD_BREAK,
+    [KC_TAB]              = WORD_BREAK,
+    [KC_SPC]              = SPACE | WORD_BREAK,
+    [KC_MINS ... KC_SCLN] = SYMBOL | WORD_BREAK,  // - = [ ] \ # ;
+    [KC_QUOT]             = QUOTE,
+    [KC_GRV]              = SYMBOL | WORD_BREAK,  // ` ~
+    [KC_COMM]             = SYMBOL | WORD_BREAK,  // , <
+    [KC_DOT]              = SYMBOL | ENDING | WORD_BREAK,  // . >
+    [KC_SLSH]             = SYMBOL | SHIFTED_ENDING | WORD_BREAK,  // / ?
+};
+// clang-format on
+
+uint8_t get_typed_keycode_class(uint16_t keycode, bool shifted) {
+  switch (keycode) {
+    case QK_LSFT ... QK_LSFT + 255:
+    case QK_RSFT ... QK_RSFT + 255:
+      shifted = true;
+      keycode = QK_MODS_GET_BASIC_KEYCODE(keycode);
+      break;
+  }
+
+  const uint8_t flags = get_keycode_class(keycode);
+  if (shifted) {
+    return (flags & ~(ENDING | SHIFTED_ENDING)) |
+           ((flags & SHIFTED_ENDING) ? ENDING : 0);
+  }
+  return flags & ~SHIFTED_ENDING;
+}
@@ -0,0 +1,90 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file keycode_class.h
+ * @brief Keycode classification table, shared by word-aware features.
+ *
+ * Caps Word, Sentence Case, and Autocorrection each classify every pressed key
+ * as a letter, digit, punctuation, word break, and so on. This library has one
+ * 256-entry PROGMEM table of class flags indexed by basic keycode, so that the
+ * classification is one table read rather than a chain of switch cases:
+ *
+ *     const uint8_t flags = get_keycode_class(keycode);
+ *     if (flags & KEYCODE_CLASS_ALPHA) {
+ *       // Letter key.
+ *     }
+ *
+ * For keys as typed, including shifted keycodes like `KC_EXLM = S(KC_1)`, use
+ * `get_typed_keycode_class()`, which accounts for shift:
+ *
+ *     const bool shifted = get_mods() & MOD_MASK_SHIFT;
+ *     if (get_typed_keycode_class(keycode, shifted) & KEYCODE_CLASS_ENDING) {
+ *       // Key types . ? or !
+ *     }
+ *
+ * The table assumes the US QWERTY layout, as do the features using it.
+ */
+
+#pragma once
+
+#include "quantum.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Letter keys, KC_A to KC_Z. */
+#define KEYCODE_CLASS_ALPHA 0x01
+/** Digit keys, KC_1 to KC_0. */
+#define KEYCODE_CLASS_DIGIT 0x02
+/** Keys typing a symbol or digit, shifted or not, excluding quotes. */
+#define KEYCODE_CLASS_SYMBOL 0x04
+/** Keys typing sentence-ending punctuation unshifted, KC_DOT. */
+#define KEYCODE_CLASS_ENDING 0x08
+/** Keys typing sentence-ending punctuation shifted, KC_1 and KC_SLSH. */
+#define KEYCODE_CLASS_SHIFTED_ENDING 0x10
+/** Quote key, KC_QUOT, typing ' or ". */
+#define KEYCODE_CLASS_QUOTE 0x20
+/** Space key, KC_SPC. */
+#define KEYCODE_CLASS_SPACE 0x40
+/**
+ * Keys that end a word for Autocorrection: space, enter, tab, digits, and
+ * symbols. Not letters, the quote, backspace, or escape.
+ */
+#define KEYCODE_CLASS_WORD_BREAK 0x80
+
+/** Class flags of each basic keycode. */
+extern const uint8_t keycode_class_table[256] PROGMEM;
+
+/** Gets the class flags of a basic keycode, or 0 for other keycodes. */
+static inline uint8_t get_keycode_class(uint16_t keycode) {
+  return (keycode <= 0xff) ? pgm_read_byte(keycode_class_table + keycode) : 0;
+}
+
+/**
+ * Gets the class flags of a key as typed.
+ *
+ * @param keycode Basic keycode, or shifted basic keycode like `S(KC_1)`.
+ * @param shifted Whether shift mods are active.
+ * @return Class flags, where `KEYCODE_CLASS_ENDING` is set if the key types
+ *         sentence-ending punctuation with the given shift state, and
+ *         `KEYCODE_CLASS_SHIFTED_ENDING` is cleared. Returns 0 for keycodes
+ *         that are neither basic nor shifted basic keycodes.
+ */
+uint8_t get_typed_keycode_class(uint16_t keycode, bool shifted);
+
+#ifdef __cplusplus
+}
+#endif
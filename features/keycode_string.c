@@ -30,8 +30,13 @@
 
 #include "quantum.h"
 
+#if KEYCODE_STRING_CACHE_SIZE > 255
+#error "keycode_string: KEYCODE_STRING_CACHE_SIZE must be at most 255."
+#endif
+
 typedef int_fast8_t index_t;
 
+#ifndef KEYCODE_STRING_NUMERIC
 // clang-format off
 /** Packs a 7-char keycode name, ignoring the third char, as 3 words. */
 #define KEYCODE_NAME7(c0, c1, unused_c2, c3, c4, c5, c6) \
@@ -79,62 +84,105 @@ static const uint16_t common_names[] PROGMEM = {
   KC_DOWN, KEYCODE_NAME7('K', 'C', '_', 'D', 'O', 'W', 'N'),
   KC_UP  , KEYCODE_NAME7('K', 'C', '_', 'U', 'P',  0 ,  0 ),
   KC_NUBS, KEYCODE_NAME7('K', 'C', '_', 'N', 'U', 'B', 'S'),
-  KC_HYPR, KEYCODE_NAME7('K', 'C', '_', 'H', 'Y', 'P', 'R'),
-  KC_MEH , KEYCODE_NAME7('K', 'C', '_', 'M', 'E', 'H',  0 ),
 #ifdef EXTRAKEY_ENABLE
+  KC_MUTE, KEYCODE_NAME7('K', 'C', '_', 'M', 'U', 'T', 'E'),
+  KC_VOLU, KEYCODE_NAME7('K', 'C', '_', 'V', 'O', 'L', 'U'),
+  KC_VOLD, KEYCODE_NAME7('K', 'C', '_', 'V', 'O', 'L', 'D'),
+  KC_MNXT, KEYCODE_NAME7('K', 'C', '_', 'M', 'N', 'X', 'T'),
+  KC_MPRV, KEYCODE_NAME7('K', 'C', '_', 'M', 'P', 'R', 'V'),
+  KC_MPLY, KEYCODE_NAME7('K', 'C', '_', 'M', 'P', 'L', 'Y'),
   KC_WHOM, KEYCODE_NAME7('K', 'C', '_', 'W', 'H', 'O', 'M'),
   KC_WBAK, KEYCODE_NAME7('K', 'C', '_', 'W', 'B', 'A', 'K'),
   KC_WFWD, KEYCODE_NAME7('K', 'C', '_', 'W', 'F', 'W', 'D'),
   KC_WSTP, KEYCODE_NAME7('K', 'C', '_', 'W', 'S', 'T', 'P'),
   KC_WREF, KEYCODE_NAME7('K', 'C', '_', 'W', 'R', 'E', 'F'),
-  KC_MNXT, KEYCODE_NAME7('K', 'C', '_', 'M', 'N', 'X', 'T'),
-  KC_MPRV, KEYCODE_NAME7('K', 'C', '_', 'M', 'P', 'R', 'V'),
-  KC_MPLY, KEYCODE_NAME7('K', 'C', '_', 'M', 'P', 'L', 'Y'),
-  KC_MUTE, KEYCODE_NAME7('K', 'C', '_', 'M', 'U', 'T', 'E'),
-  KC_VOLU, KEYCODE_NAME7('K', 'C', '_', 'V', 'O', 'L', 'U'),
-  KC_VOLD, KEYCODE_NAME7('K', 'C', '_', 'V', 'O', 'L', 'D'),
 #endif // EXTRAKEY_ENABLE
 #ifdef MOUSEKEY_ENABLE
-  MS_LEFT, KEYCODE_NAME7('M', 'S', '_', 'L', 'E', 'F', 'T'),
-  MS_RGHT, KEYCODE_NAME7('M', 'S', '_', 'R', 'G', 'H', 'T'),
   MS_UP  , KEYCODE_NAME7('M', 'S', '_', 'U', 'P',  0 ,  0 ),
   MS_DOWN, KEYCODE_NAME7('M', 'S', '_', 'D', 'O', 'W', 'N'),
-  MS_WHLL, KEYCODE_NAME7('M', 'S', '_', 'W', 'H', 'L', 'L'),
-  MS_WHLR, KEYCODE_NAME7('M', 'S', '_', 'W', 'H', 'L', 'R'),
+  MS_LEFT, KEYCODE_NAME7('M', 'S', '_', 'L', 'E', 'F', 'T'),
+  MS_RGHT, KEYCODE_NAME7('M', 'S', '_', 'R', 'G', 'H', 'T'),
   MS_WHLU, KEYCODE_NAME7('M', 'S', '_', 'W', 'H', 'L', 'U'),
   MS_WHLD, KEYCODE_NAME7('M', 'S', '_', 'W', 'H', 'L', 'D'),
+  MS_WHLL, KEYCODE_NAME7('M', 'S', '_', 'W', 'H', 'L', 'L'),
+  MS_WHLR, KEYCODE_NAME7('M', 'S', '_', 'W', 'H', 'L', 'R'),
 #endif // MOUSEKEY_ENABLE
+  KC_MEH , KEYCODE_NAME7('K', 'C', '_', 'M', 'E', 'H',  0 ),
+  KC_HYPR, KEYCODE_NAME7('K', 'C', '_', 'H', 'Y', 'P', 'R'),
 #ifdef SWAP_HANDS_ENABLE
-  SH_ON  , KEYCODE_NAME7('S', 'H', '_', 'O', 'N',  0 ,  0 ),
-  SH_OFF , KEYCODE_NAME7('S', 'H', '_', 'O', 'F', 'F',  0 ),
-  SH_MON , KEYCODE_NAME7('S', 'H', '_', 'M', 'O', 'N',  0 ),
-  SH_MOFF, KEYCODE_NAME7('S', 'H', '_', 'M', 'O', 'F', 'F'),
   SH_TOGG, KEYCODE_NAME7('S', 'H', '_', 'T', 'O', 'G', 'G'),
   SH_TT  , KEYCODE_NAME7('S', 'H', '_', 'T', 'T',  0 ,  0 ),
+  SH_MON , KEYCODE_NAME7('S', 'H', '_', 'M', 'O', 'N',  0 ),
+  SH_MOFF, KEYCODE_NAME7('S', 'H', '_', 'M', 'O', 'F', 'F'),
+  SH_OFF , KEYCODE_NAME7('S', 'H', '_', 'O', 'F', 'F',  0 ),
+  SH_ON  , KEYCODE_NAME7('S', 'H', '_', 'O', 'N',  0 ,  0 ),
 #  if !defined(NO_ACTION_ONESHOT)
   SH_OS  , KEYCODE_NAME7('S', 'H', '_', 'O', 'S',  0 ,  0 ),
 #  endif // !defined(NO_ACTION_ONESHOT)
 #endif // SWAP_HANDS_ENABLE
+  QK_BOOT, KEYCODE_NAME7('Q', 'K', '_', 'B', 'O', 'O', 'T'),
+  DB_TOGG, KEYCODE_NAME7('D', 'B', '_', 'T', 'O', 'G', 'G'),
+  EE_CLR , KEYCODE_NAME7('E', 'E', '_', 'C', 'L', 'R',  0 ),
+#ifdef GRAVE_ESC_ENABLE
+  QK_GESC, KEYCODE_NAME7('Q', 'K', '_', 'G', 'E', 'S', 'C'),
+#endif // GRAVE_ESC_ENABLE
 #ifdef LEADER_ENABLE
   QK_LEAD, KEYCODE_NAME7('Q', 'K', '_', 'L', 'E', 'A', 'D'),
 #endif // LEADER_ENABLE
+#ifdef CAPS_WORD_ENABLE
+  CW_TOGG, KEYCODE_NAME7('C', 'W', '_', 'T', 'O', 'G', 'G'),
+#endif // CAPS_WORD_ENABLE
 #ifdef TRI_LAYER_ENABLE
   TL_LOWR, KEYCODE_NAME7('T', 'L', '_', 'L', 'O', 'W', 'R'),
   TL_UPPR, KEYCODE_NAME7('T', 'L', '_', 'U', 'P', 'P', 'R'),
 #endif // TRI_LAYER_ENABLE
-#ifdef GRAVE_ESC_ENABLE
-  QK_GESC, KEYCODE_NAME7('Q', 'K', '_', 'G', 'E', 'S', 'C'),
-#endif // GRAVE_ESC_ENABLE
-#ifdef CAPS_WORD_ENABLE
-  CW_TOGG, KEYCODE_NAME7('C', 'W', '_', 'T', 'O', 'G', 'G'),
-#endif // CAPS_WORD_ENABLE
 #ifdef LAYER_LOCK_ENABLE
   QK_LLCK, KEYCODE_NAME7('Q', 'K', '_', 'L', 'L', 'C', 'K'),
 #endif // LAYER_LOCK_ENABLE
-  EE_CLR , KEYCODE_NAME7('E', 'E', '_', 'C', 'L', 'R',  0 ),
-  QK_BOOT, KEYCODE_NAME7('Q', 'K', '_', 'B', 'O', 'O', 'T'),
-  DB_TOGG, KEYCODE_NAME7('D', 'B', '_', 'T', 'O', 'G', 'G'),
 };
+
+// Entries are sorted by keycode, so that the table can be binary searched.
+// Keycode values are internal to QMK, so the order is checked at compile time.
+// All these keycodes are defined regardless of enabled features, so the checks
+// cover the full table.
+#define ASSERT_ORDER(a, b)                                    \
+  _Static_assert((a) < (b), "keycode_string: common_names must " \
+                 "be sorted by keycode, " #a " < " #b);
+ASSERT_ORDER(KC_TRNS, KC_ENT) ASSERT_ORDER(KC_ENT, KC_ESC)
+ASSERT_ORDER(KC_ESC, KC_BSPC) ASSERT_ORDER(KC_BSPC, KC_TAB)
+ASSERT_ORDER(KC_TAB, KC_SPC) ASSERT_ORDER(KC_SPC, KC_MINS)
+ASSERT_ORDER(KC_MINS, KC_EQL) ASSERT_ORDER(KC_EQL, KC_LBRC)
+ASSERT_ORDER(KC_LBRC, KC_RBRC) ASSERT_ORDER(KC_RBRC, KC_BSLS)
+ASSERT_ORDER(KC_BSLS, KC_NUHS) ASSERT_ORDER(KC_NUHS, KC_SCLN)
+ASSERT_ORDER(KC_SCLN, KC_QUOT) ASSERT_ORDER(KC_QUOT, KC_GRV)
+ASSERT_ORDER(KC_GRV, KC_COMM) ASSERT_ORDER(KC_COMM, KC_DOT)
+ASSERT_ORDER(KC_DOT, KC_SLSH) ASSERT_ORDER(KC_SLSH, KC_CAPS)
+ASSERT_ORDER(KC_CAPS, KC_PSCR) ASSERT_ORDER(KC_PSCR, KC_PAUS)
+ASSERT_ORDER(KC_PAUS, KC_INS) ASSERT_ORDER(KC_INS, KC_HOME)
+ASSERT_ORDER(KC_HOME, KC_PGUP) ASSERT_ORDER(KC_PGUP, KC_DEL)
+ASSERT_ORDER(KC_DEL, KC_END) ASSERT_ORDER(KC_END, KC_PGDN)
+ASSERT_ORDER(KC_PGDN, KC_RGHT) ASSERT_ORDER(KC_RGHT, KC_LEFT)
+ASSERT_ORDER(KC_LEFT, KC_DOWN) ASSERT_ORDER(KC_DOWN, KC_UP)
+ASSERT_ORDER(KC_UP, KC_NUBS) ASSERT_ORDER(KC_NUBS, KC_MUTE)
+ASSERT_ORDER(KC_MUTE, KC_VOLU) ASSERT_ORDER(KC_VOLU, KC_VOLD)
+ASSERT_ORDER(KC_VOLD, KC_MNXT) ASSERT_ORDER(KC_MNXT, KC_MPRV)
+ASSERT_ORDER(KC_MPRV, KC_MPLY) ASSERT_ORDER(KC_MPLY, KC_WHOM)
+ASSERT_ORDER(KC_WHOM, KC_WBAK) ASSERT_ORDER(KC_WBAK, KC_WFWD)
+ASSERT_ORDER(KC_WFWD, KC_WSTP) ASSERT_ORDER(KC_WSTP, KC_WREF)
+ASSERT_ORDER(KC_WREF, MS_UP) ASSERT_ORDER(MS_UP, MS_DOWN)
+ASSERT_ORDER(MS_DOWN, MS_LEFT) ASSERT_ORDER(MS_LEFT, MS_RGHT)
+ASSERT_ORDER(MS_RGHT, MS_WHLU) ASSERT_ORDER(MS_WHLU, MS_WHLD)
+ASSERT_ORDER(MS_WHLD, MS_WHLL) ASSERT_ORDER(MS_WHLL, MS_WHLR)
+ASSERT_ORDER(MS_WHLR, KC_MEH) ASSERT_ORDER(KC_MEH, KC_HYPR)
+ASSERT_ORDER(KC_HYPR, SH_TOGG) ASSERT_ORDER(SH_TOGG, SH_TT)
+ASSERT_ORDER(SH_TT, SH_MON) ASSERT_ORDER(SH_MON, SH_MOFF)
+ASSERT_ORDER(SH_MOFF, SH_OFF) ASSERT_ORDER(SH_OFF, SH_ON)
+ASSERT_ORDER(SH_ON, SH_OS) ASSERT_ORDER(SH_OS, QK_BOOT)
+ASSERT_ORDER(QK_BOOT, DB_TOGG) ASSERT_ORDER(DB_TOGG, EE_CLR)
+ASSERT_ORDER(EE_CLR, QK_GESC) ASSERT_ORDER(QK_GESC, QK_LEAD)
+ASSERT_ORDER(QK_LEAD, CW_TOGG) ASSERT_ORDER(CW_TOGG, TL_LOWR)
+ASSERT_ORDER(TL_LOWR, TL_UPPR) ASSERT_ORDER(TL_UPPR, QK_LLCK)
+#undef ASSERT_ORDER
 // clang-format on
 
 /** Users can override this to define names of additional keycodes. */
@@ -142,59 +190,32 @@ __attribute__((weak)) const keycode_string_name_t* keycode_string_names_data_use
 __attribute__((weak)) uint16_t keycode_string_names_size_user = 0;
 /** Names of the 4 mods on each hand. */
 static const char mod_names[] PROGMEM = "CTL\0SFT\0ALT\0GUI";
-/** Internal buffer for holding a stringified keycode. */
-static char buffer[32];
-#define BUFFER_MAX_LEN (sizeof(buffer) - 1)
-static index_t buffer_len;
-
-/** Finds the name of a keycode in `common_names` or returns NULL. */
-static const char* search_common_names(uint16_t keycode) {
-  static uint8_t buffer[8];
-
-  for (int_fast16_t offset = 0; offset < ARRAY_SIZE(common_names); offset += 4) {
-    if (keycode == pgm_read_word(common_names + offset)) {
-      const uint16_t w0 = pgm_read_word(common_names + offset + 1);
-      const uint16_t w1 = pgm_read_word(common_names + offset + 2);
-      const uint16_t w2 = pgm_read_word(common_names + offset + 3);
-      buffer[0] = (uint8_t)w0;
-      buffer[1] = (uint8_t)(w0 >> 8);
-      buffer[2] = '_';
-      buffer[3] = (uint8_t)w1;
-      buffer[4] = (uint8_t)(w1 >> 8);
-      buffer[5] = (uint8_t)w2;
-      buffer[6] = (uint8_t)(w2 >> 8);
-      buffer[7] = 0;
-      return (const char*)buffer;
-    }
-  }
+#endif  // KEYCODE_STRING_NUMERIC
 
-  return NULL;
-}
+/** Internal buffer for holding a stringified keycode. */
+static char buffer[KEYCODE_STRING_MAX_LEN + 1];
 
 /**
- * @brief Finds the name of a keycode in table or returns NULL.
+ * @brief Destination of a stringified keycode.
  *
- * @param data   Pointer to table to be searched.
- * @param size   Numer of entries in the table.
- * @return Name string for the keycode, or NULL if not found.
+ * Chars are written either to a buffer, truncating and keeping it
+ * null-terminated, or one at a time to a sink function.
  */
-static const char* search_table(
-    const keycode_string_name_t* data, uint16_t size, uint16_t keycode) {
-  if (data != NULL) {
-    for (uint16_t i = 0; i < size; ++i) {
-      if (data[i].keycode == keycode) {
-        return data[i].name;
-      }
-    }
-  }
-  return NULL;
-}
+typedef struct {
+  char* dest;  // Destination buffer, or NULL to write to `sink`.
+  uint16_t size;  // Size of `dest` in bytes, including the null terminator.
+  uint16_t len;  // Number of chars written.
+  void (*sink)(char c);
+} writer_t;
 
-/** Formats `number` in `base`, either 10 or 16. */
-static char* number_string(uint16_t number, int8_t base) {
-  static char result[7];
-  result[sizeof(result) - 1] = '\0';
-  index_t i = sizeof(result) - 1;
+/**
+ * @brief Formats `number` in `base`, either 10 or 16.
+ * @param result Buffer of at least 7 chars, to hold the result.
+ * @return Pointer into `result` to the start of the formatted number.
+ */
+static char* number_string(char* result, uint16_t number, int8_t base) {
+  index_t i = 6;
+  result[i] = '\0';
   do {
     const uint8_t digit = number % base;
     number /= base;
@@ -209,82 +230,159 @@ static char* number_string(uint16_t number, int8_t base) {
   return result + i;
 }
 
-/** Appends `str` to `buffer`, truncating if the result would overflow. */
-static void append(const char* str) {
-  char* dest = buffer + buffer_len;
-  index_t i;
-  for (i = 0; buffer_len + i < BUFFER_MAX_LEN && str[i]; ++i) {
-    dest[i] = str[i];
+/** Appends a single char, truncating if the buffer is full. */
+static void append_char(writer_t* w, char c) {
+  if (w->dest == NULL) {
+    w->sink(c);
+    ++w->len;
+  } else if (w->len + 1 < w->size) {
+    w->dest[w->len] = c;
+    w->dest[++w->len] = '\0';
   }
-  buffer_len += i;
-  buffer[buffer_len] = '\0';
 }
 
-/** Same as append(), but where `str` is a PROGMEM string. */
-static void append_P(const char* str) {
-  char* dest = buffer + buffer_len;
-  index_t i;
-  for (i = 0; buffer_len + i < BUFFER_MAX_LEN; ++i) {
-    const char c = pgm_read_byte(&str[i]);
-    if (c == '\0') {
-      break;
+/** Appends `str`, truncating if the buffer is full. */
+static void append(writer_t* w, const char* str) {
+  for (; *str; ++str) {
+    append_char(w, *str);
+  }
+}
+
+/** Formats `number` in `base`, either 10 or 16, and appends it. */
+static void append_number(writer_t* w, uint16_t number, int8_t base) {
+  char result[7];
+  append(w, number_string(result, number, base));
+}
+
+#ifndef KEYCODE_STRING_NUMERIC
+/** Appends the name of a keycode in `common_names` if found. */
+static bool append_common_name(writer_t* w, uint16_t keycode) {
+  // Binary search for the entry, with indices counting 4-word entries.
+  int_fast16_t lo = 0;
+  int_fast16_t hi = ARRAY_SIZE(common_names) / 4;
+  while (lo < hi) {
+    const int_fast16_t mid = (lo + hi) / 2;
+    const uint16_t* entry = common_names + 4 * mid;
+    const uint16_t mid_keycode = pgm_read_word(entry);
+    if (mid_keycode < keycode) {
+      lo = mid + 1;
+    } else if (mid_keycode > keycode) {
+      hi = mid;
+    } else {
+      const uint16_t w0 = pgm_read_word(entry + 1);
+      const uint16_t w1 = pgm_read_word(entry + 2);
+      const uint16_t w2 = pgm_read_word(entry + 3);
+      const char name[8] = {(char)w0, (char)(w0 >> 8), '_', (char)w1,
+                            (char)(w1 >> 8), (char)w2, (char)(w2 >> 8), 0};
+      append(w, name);
+      return true;
+    }
+  }
+
+  return false;
+}
+
+/** Returns whether `data` is sorted by keycode, allowing duplicates. */
+static bool is_table_sorted(const keycode_string_name_t* data, uint16_t size) {
+  for (uint16_t i = 1; i < size; ++i) {
+    if (data[i - 1].keycode > data[i].keycode) {
+      return false;
     }
-    dest[i] = c;
   }
-  buffer_len += i;
-  buffer[buffer_len] = '\0';
+  return true;
 }
 
-/** Appends a single char to `buffer` if there is space. */
-static void append_char(char c) {
-  if (buffer_len < BUFFER_MAX_LEN) {
-    buffer[buffer_len] = c;
-    buffer[++buffer_len] = '\0';
+/**
+ * @brief Finds the name of a keycode in table or returns NULL.
+ *
+ * If the table is sorted by keycode, it is binary searched, otherwise it is
+ * searched linearly. Either way, the first entry for the keycode is found.
+ *
+ * @param data   Pointer to table to be searched.
+ * @param size   Numer of entries in the table.
+ * @param sorted Whether the table is sorted by keycode.
+ * @return Name string for the keycode, or NULL if not found.
+ */
+static const char* search_table(const keycode_string_name_t* data,
+                                uint16_t size, bool sorted, uint16_t keycode) {
+  if (data == NULL) {
+    return NULL;
   }
+  if (sorted) {
+    // Find the first entry with keycode not less than `keycode`.
+    uint16_t lo = 0;
+    uint16_t hi = size;
+    while (lo < hi) {
+      const uint16_t mid = lo + (hi - lo) / 2;
+      if (data[mid].keycode < keycode) {
+        lo = mid + 1;
+      } else {
+        hi = mid;
+      }
+    }
+    return (lo < size && data[lo].keycode == keycode) ? data[lo].name : NULL;
+  }
+  for (uint16_t i = 0; i < size; ++i) {
+    if (data[i].keycode == keycode) {
+      return data[i].name;
+    }
+  }
+  return NULL;
 }
 
-/** Formats `number` in `base`, either 10 or 16, and appends it to `buffer`. */
-static void append_number(uint16_t number, int8_t base) {
-  append(number_string(number, base));
+/** Same as append(), but where `str` is a PROGMEM string. */
+static void append_P(writer_t* w, const char* str) {
+  for (;; ++str) {
+    const char c = pgm_read_byte(str);
+    if (c == '\0') {
+      break;
+    }
+    append_char(w, c);
+  }
 }
 
-/** Stringifies 5-bit mods and appends it to `buffer`. */
-static void append_5_bit_mods(uint8_t mods) {
+/** Stringifies 5-bit mods and appends it. */
+static void append_5_bit_mods(writer_t* w, uint8_t mods) {
   const bool is_rhs = mods > 15;
   const uint8_t csag = mods & 15;
   if (csag != 0 && (csag & (csag - 1)) == 0) { // One mod is set.
-    append_P(PSTR("MOD_"));
-    append_char(is_rhs ? 'R' : 'L');
-    append_P(&mod_names[4 * biton(csag)]);
+    append_P(w, PSTR("MOD_"));
+    append_char(w, is_rhs ? 'R' : 'L');
+    append_P(w, &mod_names[4 * biton(csag)]);
   } else { // Fallback: write the mod as a hex value.
-    append_number(mods, 16);
+    append_number(w, mods, 16);
   }
 }
 
 /**
- * @brief Writes a keycode of the format `name` + "(" + `param` + ")".
- * @note `name` is a PROGMEM string, `param` is not.
+ * @brief Writes a keycode of the format `name` + "(" + `number` + ")".
+ * @note `name` is a PROGMEM string. `number` is formatted in `base`.
  */
-static void append_unary_keycode(const char* name, const char* param) {
-  append_P(name);
-  append_char('(');
-  append(param);
-  append_char(')');
+static void append_unary_keycode(writer_t* w, const char* name,
+                                 uint16_t number, int8_t base) {
+  append_P(w, name);
+  append_char(w, '(');
+  append_number(w, number, base);
+  append_char(w, ')');
 }
 
-/** Stringifies `keycode` and appends it to `buffer`. */
-static void append_keycode(uint16_t keycode) {
+/** Stringifies `keycode` and appends it. */
+static void append_keycode(writer_t* w, uint16_t keycode) {
   // In case there is overlap among tables, search `keycode_string_names_user`
   // first so that it takes precedence.
-  const char* keycode_name = search_table(
-      keycode_string_names_data_user, keycode_string_names_size_user, keycode);
+  static int8_t user_sorted = -1;  // Whether the user table is sorted, or -1.
+  if (user_sorted < 0) {
+    user_sorted = is_table_sorted(keycode_string_names_data_user,
+                                  keycode_string_names_size_user);
+  }
+  const char* keycode_name =
+      search_table(keycode_string_names_data_user,
+                   keycode_string_names_size_user, user_sorted, keycode);
   if (keycode_name) {
-    append(keycode_name);
+    append(w, keycode_name);
     return;
   }
-  keycode_name = search_common_names(keycode);
-  if (keycode_name) {
-    append(keycode_name);
+  if (append_common_name(w, keycode)) {
     return;
   }
 
@@ -294,38 +392,38 @@ static void append_keycode(uint16_t keycode) {
       case MODIFIER_KEYCODE_RANGE: {
         const uint8_t i = keycode - KC_LCTL;
         const bool is_rhs = i > 3;
-        append_P(PSTR("KC_"));
-        append_char(is_rhs ? 'R' : 'L');
-        append_P(&mod_names[4 * (i & 3)]);
+        append_P(w, PSTR("KC_"));
+        append_char(w, is_rhs ? 'R' : 'L');
+        append_P(w, &mod_names[4 * (i & 3)]);
       } return;
 
       // Letters A-Z.
       case KC_A ... KC_Z:
-        append_P(PSTR("KC_"));
-        append_char((char)(keycode + (UINT8_C('A') - KC_A)));
+        append_P(w, PSTR("KC_"));
+        append_char(w, (char)(keycode + (UINT8_C('A') - KC_A)));
         return;
 
       // Digits 0-9 (NOTE: Unlike the ASCII order, KC_0 comes *after* KC_9.)
       case KC_1 ... KC_0:
-        append_P(PSTR("KC_"));
-        append_char('0' + (char)((keycode - (KC_1 - 1)) % 10));
+        append_P(w, PSTR("KC_"));
+        append_char(w, '0' + (char)((keycode - (KC_1 - 1)) % 10));
         return;
 
       // Keypad digits.
       case KC_KP_1 ... KC_KP_0:
-        append_P(PSTR("KC_KP_"));
-        append_char('0' + (char)((keycode - (KC_KP_1 - 1)) % 10));
+        append_P(w, PSTR("KC_KP_"));
+        append_char(w, '0' + (char)((keycode - (KC_KP_1 - 1)) % 10));
         return;
 
       // Function keys. F1-F12 and F13-F24 are coded in separate ranges.
       case KC_F1 ... KC_F12:
-        append_P(PSTR("KC_F"));
-        append_number(keycode - (KC_F1 - 1), 10);
+        append_P(w, PSTR("KC_F"));
+        append_number(w, keycode - (KC_F1 - 1), 10);
         return;
 
       case KC_F13 ... KC_F24:
-        append_P(PSTR("KC_F"));
-        append_number(keycode - (KC_F13 - 13), 10);
+        append_P(w, PSTR("KC_F"));
+        append_number(w, keycode - (KC_F13 - 13), 10);
         return;
     }
   }
@@ -342,14 +440,14 @@ static void append_keycode(uint16_t keycode) {
       if (mods != 0 && (mods & (mods - 1)) == 0) {  // One mod is set.
         const char* name = &mod_names[4 * biton(mods)];
         if (is_rhs) {
-          append_char('R');
-          append_P(name);
+          append_char(w, 'R');
+          append_P(w, name);
         } else {
-          append_char(pgm_read_byte(&name[0]));
+          append_char(w, pgm_read_byte(&name[0]));
         }
-        append_char('(');
-        append_keycode(QK_MODS_GET_BASIC_KEYCODE(keycode));
-        append_char(')');
+        append_char(w, '(');
+        append_keycode(w, QK_MODS_GET_BASIC_KEYCODE(keycode));
+        append_char(w, ')');
         return;
       }
     } break;
@@ -357,65 +455,62 @@ static void append_keycode(uint16_t keycode) {
 #if !defined(NO_ACTION_ONESHOT)
     // One-shot mod OSM(mod) key.
     case QK_ONE_SHOT_MOD ... QK_ONE_SHOT_MOD_MAX:
-      append_P(PSTR("OSM("));
-      append_5_bit_mods(QK_ONE_SHOT_MOD_GET_MODS(keycode));
-      append_char(')');
+      append_P(w, PSTR("OSM("));
+      append_5_bit_mods(w, QK_ONE_SHOT_MOD_GET_MODS(keycode));
+      append_char(w, ')');
       return;
 #endif  // !defined(NO_ACTION_ONESHOT)
 
     // Various layer switch keys.
     case QK_LAYER_TAP ... QK_LAYER_TAP_MAX:  // Layer-tap LT(layer,kc) key.
-      append_P(PSTR("LT("));
-      append_number(QK_LAYER_TAP_GET_LAYER(keycode), 10);
-      append_char(',');
-      append_keycode(QK_LAYER_TAP_GET_TAP_KEYCODE(keycode));
-      append_char(')');
+      append_P(w, PSTR("LT("));
+      append_number(w, QK_LAYER_TAP_GET_LAYER(keycode), 10);
+      append_char(w, ',');
+      append_keycode(w, QK_LAYER_TAP_GET_TAP_KEYCODE(keycode));
+      append_char(w, ')');
       return;
 
     case QK_LAYER_MOD ... QK_LAYER_MOD_MAX:  // LM(layer,mod) key.
-      append_P(PSTR("LM("));
-      append_number(QK_LAYER_MOD_GET_LAYER(keycode), 10);
-      append_char(',');
-      append_5_bit_mods(QK_LAYER_MOD_GET_MODS(keycode));
-      append_char(')');
+      append_P(w, PSTR("LM("));
+      append_number(w, QK_LAYER_MOD_GET_LAYER(keycode), 10);
+      append_char(w, ',');
+      append_5_bit_mods(w, QK_LAYER_MOD_GET_MODS(keycode));
+      append_char(w, ')');
       return;
 
     case QK_TO ... QK_TO_MAX:  // TO(layer) key.
-      append_unary_keycode(PSTR("TO"),
-          number_string(QK_TO_GET_LAYER(keycode), 10));
+      append_unary_keycode(w, PSTR("TO"), QK_TO_GET_LAYER(keycode), 10);
       return;
 
     case QK_MOMENTARY ... QK_MOMENTARY_MAX:  // MO(layer) key.
-      append_unary_keycode(PSTR("MO"),
-          number_string(QK_MOMENTARY_GET_LAYER(keycode), 10));
+      append_unary_keycode(w, PSTR("MO"), QK_MOMENTARY_GET_LAYER(keycode), 10);
       return;
 
     case QK_DEF_LAYER ... QK_DEF_LAYER_MAX:  // DF(layer) key.
-      append_unary_keycode(PSTR("DF"),
-          number_string(QK_DEF_LAYER_GET_LAYER(keycode), 10));
+      append_unary_keycode(w, PSTR("DF"), QK_DEF_LAYER_GET_LAYER(keycode), 10);
       return;
 
     case QK_TOGGLE_LAYER ... QK_TOGGLE_LAYER_MAX:  // TG(layer) key.
-      append_unary_keycode(PSTR("TG"),
-          number_string(QK_TOGGLE_LAYER_GET_LAYER(keycode), 10));
+      append_unary_keycode(w, PSTR("TG"),
+          QK_TOGGLE_LAYER_GET_LAYER(keycode), 10);
       return;
 
 #if !defined(NO_ACTION_ONESHOT)
     case QK_ONE_SHOT_LAYER ... QK_ONE_SHOT_LAYER_MAX:  // OSL(layer) key.
-      append_unary_keycode(PSTR("OSL"),
-          number_string(QK_ONE_SHOT_LAYER_GET_LAYER(keycode), 10));
+      append_unary_keycode(w, PSTR("OSL"),
+          QK_ONE_SHOT_LAYER_GET_LAYER(keycode), 10);
       return;
 #endif  // !defined(NO_ACTION_ONESHOT)
 
     case QK_LAYER_TAP_TOGGLE ... QK_LAYER_TAP_TOGGLE_MAX:  // TT(layer) key.
-      append_unary_keycode(PSTR("TT"),
-          number_string(QK_LAYER_TAP_TOGGLE_GET_LAYER(keycode), 10));
+      append_unary_keycode(w, PSTR("TT"),
+          QK_LAYER_TAP_TOGGLE_GET_LAYER(keycode), 10);
       return;
 
     // PDF(layer) key.
     case QK_PERSISTENT_DEF_LAYER ... QK_PERSISTENT_DEF_LAYER_MAX:
-      append_unary_keycode(PSTR("PDF"),
-          number_string(QK_PERSISTENT_DEF_LAYER_GET_LAYER(keycode), 10));
+      append_unary_keycode(w, PSTR("PDF"),
+          QK_PERSISTENT_DEF_LAYER_GET_LAYER(keycode), 10);
       return;
 
     // Mod-tap MT(mod,kc) key. This implementation formats the MT keys where
@@ -426,83 +521,151 @@ static void append_keycode(uint16_t keycode) {
       const bool is_rhs = mods > 15;
       const uint8_t csag = mods & 15;
       if (csag != 0 && (csag & (csag - 1)) == 0) { // One mod is set.
-        append_char(is_rhs ? 'R' : 'L');
-        append_P(&mod_names[4 * biton(csag)]);
-        append_P(PSTR("_T("));
+        append_char(w, is_rhs ? 'R' : 'L');
+        append_P(w, &mod_names[4 * biton(csag)]);
+        append_P(w, PSTR("_T("));
       } else if (mods == MOD_HYPR) {
-        append_P(PSTR("HYPR_T("));
+        append_P(w, PSTR("HYPR_T("));
       } else if (mods == MOD_MEH) {
-        append_P(PSTR("MEH_T("));
+        append_P(w, PSTR("MEH_T("));
       } else {
-        append_P(PSTR("MT("));
-        append_number(mods, 16);
-        append_char(',');
+        append_P(w, PSTR("MT("));
+        append_number(w, mods, 16);
+        append_char(w, ',');
       }
-      append_keycode(QK_MOD_TAP_GET_TAP_KEYCODE(keycode));
-      append_char(')');
+      append_keycode(w, QK_MOD_TAP_GET_TAP_KEYCODE(keycode));
+      append_char(w, ')');
     } return;
 
     case QK_TAP_DANCE ... QK_TAP_DANCE_MAX:  // Tap dance TD(i) key.
-      append_unary_keycode(PSTR("TD"),
-          number_string(QK_TAP_DANCE_GET_INDEX(keycode), 10));
+      append_unary_keycode(w, PSTR("TD"), QK_TAP_DANCE_GET_INDEX(keycode), 10);
       return;
 
 #ifdef UNICODE_ENABLE
     case QK_UNICODE ... QK_UNICODE_MAX:  // Unicode UC(codepoint) key.
-      append_unary_keycode(PSTR("UC"),
-          number_string(QK_UNICODE_GET_CODE_POINT(keycode), 16));
+      append_unary_keycode(w, PSTR("UC"),
+          QK_UNICODE_GET_CODE_POINT(keycode), 16);
       return;
 #elif defined(UNICODEMAP_ENABLE)
     case QK_UNICODEMAP ... QK_UNICODEMAP_MAX:  // Unicode Map UM(i) key.
-      append_unary_keycode(PSTR("UM"),
-          number_string(QK_UNICODEMAP_GET_INDEX(keycode), 10));
+      append_unary_keycode(w, PSTR("UM"), QK_UNICODEMAP_GET_INDEX(keycode), 10);
       return;
 
     case QK_UNICODEMAP_PAIR ... QK_UNICODEMAP_PAIR_MAX: {  // UP(i,j) key.
       const uint8_t i = QK_UNICODEMAP_PAIR_GET_UNSHIFTED_INDEX(keycode);
       const uint8_t j = QK_UNICODEMAP_PAIR_GET_SHIFTED_INDEX(keycode);
-      append_P(PSTR("UP("));
-      append_number(i, 10);
-      append_char(',');
-      append_number(j, 10);
-      append_char(')');
+      append_P(w, PSTR("UP("));
+      append_number(w, i, 10);
+      append_char(w, ',');
+      append_number(w, j, 10);
+      append_char(w, ')');
     } return;
 #endif
 #ifdef MOUSEKEY_ENABLE
     case MS_BTN1 ... MS_BTN8:  // Mouse button keycode.
-      append_P(PSTR("MS_BTN"));
-      append_number(keycode - (MS_BTN1 - 1), 10);
+      append_P(w, PSTR("MS_BTN"));
+      append_number(w, keycode - (MS_BTN1 - 1), 10);
       return;
 #endif // MOUSEKEY_ENABLE
 #ifdef SWAP_HANDS_ENABLE
     case QK_SWAP_HANDS ... QK_SWAP_HANDS_MAX:  // Swap Hands SH_T(kc) key.
       if (!IS_SWAP_HANDS_KEYCODE(keycode)) {
-        append_P(PSTR("SH_T("));
-        append_keycode(QK_SWAP_HANDS_GET_TAP_KEYCODE(keycode));
-        append_char(')');
+        append_P(w, PSTR("SH_T("));
+        append_keycode(w, QK_SWAP_HANDS_GET_TAP_KEYCODE(keycode));
+        append_char(w, ')');
         return;
       }
       break;
 #endif // SWAP_HANDS_ENABLE
 
     case KB_KEYCODE_RANGE:  // Keyboard range keycode.
-      append_P(PSTR("QK_KB_"));
-      append_number(keycode - QK_KB_0, 10);
+      append_P(w, PSTR("QK_KB_"));
+      append_number(w, keycode - QK_KB_0, 10);
       return;
 
     case USER_KEYCODE_RANGE:  // User range keycode.
-      append_P(PSTR("QK_USER_"));
-      append_number(keycode - QK_USER_0, 10);
+      append_P(w, PSTR("QK_USER_"));
+      append_number(w, keycode - QK_USER_0, 10);
       return;
   }
   // clang-format on
 
-  append_number(keycode, 16); // Fallback: write keycode as hex value.
+  append_number(w, keycode, 16); // Fallback: write keycode as hex value.
+}
+#else
+/** Appends `keycode` as a hex value. Names are looked up on the host. */
+static void append_keycode(writer_t* w, uint16_t keycode) {
+  append_number(w, keycode, 16);
 }
+#endif  // KEYCODE_STRING_NUMERIC
+
+#if KEYCODE_STRING_CACHE_SIZE > 0
+/** Recently formatted keycodes. */
+static struct {
+  uint16_t keycode;
+  char string[sizeof(buffer)];
+} cache[KEYCODE_STRING_CACHE_SIZE];
+/** Indices into `cache`, most recently used first. */
+static uint8_t cache_order[KEYCODE_STRING_CACHE_SIZE];
+/** Number of `cache` entries in use. */
+static uint8_t cache_count = 0;
+
+/** Moves position `i` of `cache_order` to the front and returns its entry. */
+static uint8_t cache_touch(uint8_t i) {
+  const uint8_t slot = cache_order[i];
+  for (; i > 0; --i) {
+    cache_order[i] = cache_order[i - 1];
+  }
+  cache_order[0] = slot;
+  return slot;
+}
+#endif  // KEYCODE_STRING_CACHE_SIZE > 0
 
 const char* get_keycode_string(uint16_t keycode) {
-  buffer_len = 0;
-  buffer[0] = '\0';
-  append_keycode(keycode);
+#if KEYCODE_STRING_CACHE_SIZE > 0
+  for (uint8_t i = 0; i < cache_count; ++i) {
+    if (cache[cache_order[i]].keycode == keycode) {
+      return cache[cache_touch(i)].string;
+    }
+  }
+#endif  // KEYCODE_STRING_CACHE_SIZE > 0
+
+  const uint16_t len = get_keycode_string_r(keycode, buffer, sizeof(buffer));
+
+#if KEYCODE_STRING_CACHE_SIZE > 0
+  // Evict the least recently used entry, or take an unused one.
+  if (cache_count < KEYCODE_STRING_CACHE_SIZE) {
+    cache_order[cache_count] = cache_count;
+    ++cache_count;
+  }
+  const uint8_t slot = cache_touch(cache_count - 1);
+  cache[slot].keycode = keycode;
+  memcpy(cache[slot].string, buffer, len + 1);
+  return cache[slot].string;
+#else
+  (void)len;
   return buffer;
+#endif  // KEYCODE_STRING_CACHE_SIZE > 0
+}
+
+uint16_t get_keycode_string_r(uint16_t keycode, char* dest, uint16_t size) {
+  if (size == 0) {
+    return 0;
+  }
+  writer_t w = {.dest = dest, .size = size};
+  dest[0] = '\0';
+  append_keycode(&w, keycode);
+  return w.len;
+}
+
+uint16_t write_keycode_string(uint16_t keycode, void (*sink)(char c)) {
+  writer_t w = {.sink = sink};
+  append_keycode(&w, keycode);
+  return w.len;
+}
+
+static void sendchar_sink(char c) { sendchar((uint8_t)c); }
+
+uint16_t print_keycode_string(uint16_t keycode) {
+  return write_keycode_string(keycode, sendchar_sink);
 }
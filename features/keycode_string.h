@@ -43,6 +43,18 @@
 extern "C" {
 #endif
 
+/**
+ * Number of recently formatted keycodes that `get_keycode_string()` caches,
+ * so that logging a burst of typing formats each distinct key once. Each entry
+ * takes 34 bytes of RAM. Define as 0 in config.h to disable the cache.
+ */
+#ifndef KEYCODE_STRING_CACHE_SIZE
+#define KEYCODE_STRING_CACHE_SIZE 4
+#endif  // KEYCODE_STRING_CACHE_SIZE
+
+/** Maximum length of a string returned by `get_keycode_string()`. */
+#define KEYCODE_STRING_MAX_LEN 31
+
 /**
  * @brief Formats a QMK keycode as a human-readable string.
  *
@@ -52,6 +64,7 @@ extern "C" {
  *
  * @note The returned char* string should be used right away. The string memory
  * is reused and will be overwritten by the next call to `get_keycode_string()`.
+ * Use `get_keycode_string_r()` to format into your own buffer instead.
  *
  * Many common QMK keycodes are understood by this function, but not all.
  * Recognized keycodes include:
@@ -91,6 +104,49 @@ extern "C" {
  */
 const char* get_keycode_string(uint16_t keycode);
 
+/**
+ * @brief Formats a QMK keycode into a caller-provided buffer.
+ *
+ * Reentrant variant of `get_keycode_string()`, convenient for formatting
+ * several keycodes in one log line:
+ *
+ *     char tap[KEYCODE_STRING_MAX_LEN + 1];
+ *     char hold[KEYCODE_STRING_MAX_LEN + 1];
+ *     get_keycode_string_r(tap_keycode, tap, sizeof(tap));
+ *     get_keycode_string_r(hold_keycode, hold, sizeof(hold));
+ *     xprintf("tap=%s hold=%s\n", tap, hold);
+ *
+ * @param keycode  QMK keycode.
+ * @param dest     Buffer to write the null-terminated string to.
+ * @param size     Size of `dest` in bytes. The string is truncated to fit.
+ * @return         Length of the written string, excluding the terminator.
+ */
+uint16_t get_keycode_string_r(uint16_t keycode, char* dest, uint16_t size);
+
+/**
+ * @brief Formats a QMK keycode, passing it one char at a time to `sink`.
+ *
+ * @param keycode  QMK keycode.
+ * @param sink     Function called with each char of the string.
+ * @return         Length of the string.
+ */
+uint16_t write_keycode_string(uint16_t keycode, void (*sink)(char c));
+
+/**
+ * @brief Formats a QMK keycode directly to the console.
+ *
+ * Like `write_keycode_string()` with the console's `sendchar()` as the sink,
+ * so that debug logging needs no intermediate buffer:
+ *
+ *     xprintf("L%-2u: %-7s kc=", layer, pressed ? "press" : "release");
+ *     print_keycode_string(keycode);
+ *     xprintf("\n");
+ *
+ * @param keycode  QMK keycode.
+ * @return         Length of the string.
+ */
+uint16_t print_keycode_string(uint16_t keycode);
+
 /** @deprecated Use `get_keycode_string()` instead. */
 static inline const char* keycode_string(uint16_t keycode) {
   return get_keycode_string(keycode);
@@ -120,7 +176,18 @@ typedef struct {
  *
  * The above defines names for `MYMACRO1` and `MYMACRO2`, and overrides
  * `KC_EXLM` to format as "KC_EXLM" instead of the default "S(KC_1)".
+ *
+ * Entries may be in any order, but if they are sorted by keycode, the table is
+ * binary searched rather than scanned.
  */
+#ifdef KEYCODE_STRING_NUMERIC
+// With `KEYCODE_STRING_NUMERIC` defined in config.h, every keycode is formatted
+// as a hex value like "0x7E40". This leaves out the name tables, a couple KB of
+// flash, including this user table. Names are instead recovered from logs on
+// the host with tools/host_sim/trace_decode.
+#define KEYCODE_STRING_NAMES_USER(...) \
+  extern uint16_t keycode_string_names_size_user
+#else
 #define KEYCODE_STRING_NAMES_USER(...)                                    \
   static const keycode_string_name_t keycode_string_names_user[] =        \
       {__VA_ARGS__};                                                      \
@@ -128,6 +195,7 @@ typedef struct {
       sizeof(keycode_string_names_user) / sizeof(keycode_string_name_t);  \
   const keycode_string_name_t* keycode_string_names_data_user =           \
       keycode_string_names_user
+#endif  // KEYCODE_STRING_NUMERIC
 
 /** Helper to define a keycode_string_name_t. */
 #define KEYCODE_STRING_NAME(kc) {(kc), #kc}
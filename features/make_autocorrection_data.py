@@ -29,6 +29,26 @@ dictionary. Or optionally specify the output .h file as well like
 
 $ python3 make_autocorrection_data.py dict.txt somewhere/out.h
 
+By default, the trie is serialized in a compact byte-oriented form, where the
+children of a node are searched linearly. Alternatively, pass
+--format=double-array to serialize it as a double-array trie, which is larger
+but finds the child for a given character in constant time:
+
+$ python3 make_autocorrection_data.py --format=double-array
+
+The sizes of both encodings are printed either way, to help choose per board.
+
+Node links are 16-bit, limiting the table to 64 KB, unless it is too large, in
+which case they are made 24-bit. This may be set explicitly with
+--link-bytes=2 or --link-bytes=3. Tables of 24-bit links can't be read on AVR.
+To save space with large dictionaries, pass --string-pool to store the
+corrections in a separate pool, where corrections that are a suffix of another
+share its storage.
+
+Typos are validated against each other and against an English dictionary with
+an Aho-Corasick automaton, taking seconds even for tens of thousands of typos.
+Pass --jobs=N to split the dictionary check over N processes.
+
 Each line of the dict file defines one typo and its correction with the syntax
 "typo -> correction". Blank lines or lines starting with '#' are ignored.
 Example:
@@ -46,10 +66,12 @@ For full documentation, see
 https://getreuer.info/posts/keyboards/autocorrection
 """
 
+import argparse
+import collections
 import os.path
 import sys
 import textwrap
-from typing import Any, Dict, Iterator, List, Tuple
+from typing import Any, Dict, Iterator, List, Optional, Tuple
 
 try:
   from english_words import english_words_lower_alpha_set as CORRECT_WORDS
@@ -68,6 +90,12 @@ KC_A = 4
 KC_SPC = 0x2c
 KC_QUOT = 0x34
 
+# Flag on a double-array base value marking a leaf. The low bits are then the
+# offset of the leaf data in the leaves array.
+DOUBLE_ARRAY_LEAF = 0x8000
+# Check value of an unused double-array slot.
+DOUBLE_ARRAY_UNUSED = 0xffff
+
 TYPO_CHARS = dict(
   [
     ("'", KC_QUOT),
@@ -77,8 +105,18 @@ TYPO_CHARS = dict(
   [(chr(c), c + KC_A - ord('a')) for c in range(ord('a'), ord('z') + 1)]
 )
 
+# Symbols of the double-array trie. These must match key_to_symbol() in
+# autocorrection.c.
+DOUBLE_ARRAY_SYMBOLS = dict(
+  [(chr(c), c - ord('a') + 1) for c in range(ord('a'), ord('z') + 1)] +
+  [
+    (':', 27),
+    ("'", 28),
+  ]
+)
+
 
-def parse_file(file_name: str) -> List[Tuple[str, str]]:
+def parse_file(file_name: str, jobs: int = 1) -> List[Tuple[str, str]]:
   """Parses autocorrections dictionary file.
 
   Each line of the file defines one typo and its correction with the syntax
@@ -89,11 +127,13 @@ def parse_file(file_name: str) -> List[Tuple[str, str]]:
 
   Args:
     file_name: String, path of the autocorrections dictionary.
+    jobs: Int, number of processes for checking against CORRECT_WORDS.
   Returns:
     List of (typo, correction) tuples.
   """
 
   autocorrections = []
+  line_numbers = []
   typos = set()
   for line_number, typo, correction in parse_file_lines(file_name):
     if typo in typos:
@@ -105,26 +145,91 @@ def parse_file(file_name: str) -> List[Tuple[str, str]]:
       print(f'Error:{line_number}: Typo "{typo}" has '
             'characters other than ' + ''.join(TYPO_CHARS.keys()))
       sys.exit(1)
-    for other_typo in typos:
-      if typo in other_typo or other_typo in typo:
-        print(f'Error:{line_number}: Typos may not be substrings of one '
-              f'another, otherwise the longer typo would never trigger: '
-              f'"{typo}" vs. "{other_typo}".')
-        sys.exit(1)
     if len(typo) < 5:
       print(f'Warning:{line_number}: It is suggested that typos are at '
             f'least 5 characters long to avoid false triggers: "{typo}"')
 
-    check_typo_against_dictionary(line_number, typo)
-
     autocorrections.append((typo, correction))
+    line_numbers.append(line_number)
     typos.add(typo)
 
+  typo_list = [typo for typo, _ in autocorrections]
+  automaton = AhoCorasick(typo_list)
+  check_typos_against_each_other(automaton, typo_list, line_numbers)
+  check_typos_against_dictionary(typo_list, line_numbers, jobs)
   return autocorrections
 
 
+class AhoCorasick:
+  """Aho-Corasick automaton, finding all occurrences of a set of patterns.
+
+  Building takes time linear in the total length of the patterns. Then a text
+  is searched in a single pass, in time linear in its length plus the number
+  of matches.
+  """
+
+  def __init__(self, patterns: List[str]):
+    self.goto = [{}]  # Trie transitions of each state.
+    self.fail = [0]  # Longest proper suffix of each state that is a state.
+    self.output = [()]  # Indices of the patterns ending at each state.
+
+    for i, pattern in enumerate(patterns):
+      state = 0
+      for c in pattern:
+        if c not in self.goto[state]:
+          self.goto[state][c] = len(self.goto)
+          self.goto.append({})
+          self.fail.append(0)
+          self.output.append(())
+        state = self.goto[state][c]
+      self.output[state] += (i,)
+
+    # Compute failure links in breadth first order.
+    queue = list(self.goto[0].values())
+    for state in queue:
+      for c, child in self.goto[state].items():
+        fallback = self.fail[state]
+        while fallback and c not in self.goto[fallback]:
+          fallback = self.fail[fallback]
+        self.fail[child] = self.goto[fallback].get(c, 0)
+        self.output[child] += self.output[self.fail[child]]
+        queue.append(child)
+
+  def search(self, text: str) -> Iterator[int]:
+    """Yields the index of each pattern occurrence in `text`."""
+    state = 0
+    for c in text:
+      while state and c not in self.goto[state]:
+        state = self.fail[state]
+      state = self.goto[state].get(c, 0)
+      yield from self.output[state]
+
+
+def check_typos_against_each_other(automaton: AhoCorasick,
+                                   typos: List[str],
+                                   line_numbers: List[int]) -> None:
+  """Checks that no typo is a substring of another."""
+  conflicts = []
+  for i, typo in enumerate(typos):
+    for j in automaton.search(typo):
+      if j != i:
+        conflicts.append((max(line_numbers[i], line_numbers[j]), i, j))
+
+  if conflicts:
+    line_number, i, j = min(conflicts)  # Report the first one in the file.
+    if line_numbers[i] < line_numbers[j]:
+      i, j = j, i
+    print(f'Error:{line_number}: Typos may not be substrings of one '
+          f'another, otherwise the longer typo would never trigger: '
+          f'"{typos[i]}" vs. "{typos[j]}".')
+    sys.exit(1)
+
+
 def make_trie(autocorrections: List[Tuple[str, str]]) -> Dict[str, Any]:
-  """Makes a trie from the the typos, writing in reverse.
+  """Makes a trie from the the typos.
+
+  The trie is written forward, in typing order. The keyboard walks it
+  incrementally, advancing each partial match by one node per keypress.
 
   Args:
     autocorrections: List of (typo, correction) tuples.
@@ -134,7 +239,7 @@ def make_trie(autocorrections: List[Tuple[str, str]]) -> Dict[str, Any]:
   trie = {}
   for typo, correction in autocorrections:
     node = trie
-    for letter in typo[::-1]:
+    for letter in typo:
       node = node.setdefault(letter, {})
     node['LEAF'] = (typo, correction)
 
@@ -162,56 +267,81 @@ def parse_file_lines(file_name: str) -> Iterator[Tuple[int, str, str]]:
       yield line_number, typo, correction
 
 
-def check_typo_against_dictionary(line_number: int, typo: str) -> None:
-  """Checks `typo` against English dictionary words."""
+# Automaton over the typos, for dictionary checking in worker processes.
+_worker_automaton = None
+
+
+def _init_dictionary_worker(typos: List[str]) -> None:
+  global _worker_automaton
+  _worker_automaton = AhoCorasick(typos)
+
 
-  if typo.startswith(':') and typo.endswith(':'):
-    if typo[1:-1] in CORRECT_WORDS:
-      print(f'Warning:{line_number}: Typo "{typo}" is a correctly spelled '
+def _find_triggering_words(words: List[str]) -> List[Tuple[int, str]]:
+  """Finds (typo index, word) pairs where the typo triggers on the word."""
+  # Surrounding the word with word breaks, a typo occurs in ":word:" exactly
+  # when it would trigger while typing the word. E.g. ":thier" occurs if the
+  # word starts with "thier", and ":thier:" only if the word is "thier".
+  return [(i, word) for word in words
+          for i in _worker_automaton.search(f':{word}:')]
+
+
+def check_typos_against_dictionary(typos: List[str],
+                                   line_numbers: List[int],
+                                   jobs: int = 1) -> None:
+  """Checks typos against English dictionary words.
+
+  Each dictionary word is searched once for all typos with an Aho-Corasick
+  automaton. With `jobs` > 1, the words are split among that many processes.
+  """
+  words = sorted(CORRECT_WORDS)
+  if jobs > 1 and len(words) > 1000:
+    import multiprocessing
+    chunk_size = (len(words) + 4 * jobs - 1) // (4 * jobs)
+    chunks = [words[k:k + chunk_size]
+              for k in range(0, len(words), chunk_size)]
+    with multiprocessing.Pool(jobs, _init_dictionary_worker,
+                              (typos,)) as pool:
+      matches = [m for chunk_matches in pool.map(_find_triggering_words, chunks)
+                 for m in chunk_matches]
+  else:
+    _init_dictionary_worker(typos)
+    matches = _find_triggering_words(words)
+
+  for i, word in sorted(matches, key=lambda m: (line_numbers[m[0]], m[1])):
+    typo = typos[i]
+    if typo.startswith(':') and typo.endswith(':'):
+      print(f'Warning:{line_numbers[i]}: Typo "{typo}" is a correctly spelled '
             'dictionary word.')
-  elif typo.startswith(':') and not typo.endswith(':'):
-    for word in CORRECT_WORDS:
-      if word.startswith(typo[1:]):
-        print(f'Warning:{line_number}: Typo "{typo}" would falsely trigger '
-              f'on correctly spelled word "{word}".')
-  elif not typo.startswith(':') and typo.endswith(':'):
-    for word in CORRECT_WORDS:
-      if word.endswith(typo[:-1]):
-        print(f'Warning:{line_number}: Typo "{typo}" would falsely trigger '
-              f'on correctly spelled word "{word}".')
-  elif not typo.startswith(':') and not typo.endswith(':'):
-    for word in CORRECT_WORDS:
-      if typo in word:
-        print(f'Warning:{line_number}: Typo "{typo}" would falsely trigger '
-              f'on correctly spelled word "{word}".')
+    else:
+      print(f'Warning:{line_numbers[i]}: Typo "{typo}" would falsely trigger '
+            f'on correctly spelled word "{word}".')
 
 
 def serialize_trie(autocorrections: List[Tuple[str, str]],
-                   trie: Dict[str, Any]) -> List[int]:
+                   trie: Dict[str, Any],
+                   link_bytes: int = 2,
+                   pool_offsets: Optional[Dict[str, int]] = None,
+                   pool_bytes: int = 2) -> List[int]:
   """Serializes trie and correction data in a form readable by the C code.
 
   Args:
     autocorrections: List of (typo, correction) tuples.
     trie: Dict of dicts.
+    link_bytes: Int, 2 or 3, the number of bytes per node link.
+    pool_offsets: Optional dict of correction string pool offsets, as made by
+      make_string_pool(). If None, corrections are stored in the leaves.
+    pool_bytes: Int, 2 or 3, the number of bytes per pool offset.
   Returns:
     List of ints in the range 0-255.
+  Raises:
+    ValueError: if a link does not fit in `link_bytes` bytes.
   """
   table = []
 
   # Traverse trie in depth first order.
   def traverse(trie_node: Dict[str, Any]) -> Dict[str, Any]:
     if 'LEAF' in trie_node:  # Handle a leaf trie node.
-      typo, correction = trie_node['LEAF']
-      word_boundary_ending = typo[-1] == ':'
-      typo = typo.strip(':')
-      i = 0  # Make the autocorrection data for this entry and serialize it.
-      while i < min(len(typo), len(correction)) and typo[i] == correction[i]:
-        i += 1
-      backspaces = len(typo) - i - 1 + word_boundary_ending
-      assert 0 <= backspaces <= 63
-      correction = correction[i:]
-      data = [backspaces + 128] + list(bytes(correction, 'ascii')) + [0]
-
+      data = make_leaf_data(*trie_node['LEAF'], pool_offsets, pool_bytes)
       entry = {'data': data, 'links': [], 'byte_offset': 0}
       table.append(entry)
     elif len(trie_node) == 1:  # Handle trie node with a single child.
@@ -242,7 +372,8 @@ def serialize_trie(autocorrections: List[Tuple[str, str]],
     else:  # Handle a branch table entry.
       data = []
       for c, link in zip(e['chars'], e['links']):
-        data += [TYPO_CHARS[c] | (0 if data else 64)] + encode_link(link)
+        data += ([TYPO_CHARS[c] | (0 if data else 64)] +
+                 encode_offset(link['byte_offset'], link_bytes))
       return data + [0]
 
   byte_offset = 0
@@ -253,27 +384,177 @@ def serialize_trie(autocorrections: List[Tuple[str, str]],
   return [b for e in table for b in serialize(e)]  # Serialize final table.
 
 
-def encode_link(link: Dict[str, Any]) -> List[int]:
-  """Encodes a node link as two bytes."""
-  byte_offset = link['byte_offset']
-  if not (0 <= byte_offset <= 0xffff):
-    print('Error: The autocorrection table is too large, a node link exceeds '
-          '64KB limit. Try reducing the autocorrection dict to fewer entries.')
-    sys.exit(1)
-  return [byte_offset & 255, byte_offset >> 8]
+def split_correction(typo: str, correction: str) -> Tuple[int, str]:
+  """Gets the backspaces and text to type to correct `typo`."""
+  word_boundary_ending = typo[-1] == ':'
+  typo = typo.strip(':')
+  i = 0  # Skip the common prefix of the typo and correction.
+  while i < min(len(typo), len(correction)) and typo[i] == correction[i]:
+    i += 1
+  backspaces = len(typo) - i - 1 + word_boundary_ending
+  assert 0 <= backspaces <= 63
+  return backspaces, correction[i:]
+
+
+def make_leaf_data(typo: str, correction: str,
+                   pool_offsets: Optional[Dict[str, int]] = None,
+                   pool_bytes: int = 2) -> List[int]:
+  """Makes the serialized leaf for an entry.
+
+  The leaf is a byte 128 + backspaces, followed by either the null-terminated
+  correction text or, if `pool_offsets` is given, its offset in the string pool.
+  """
+  backspaces, text = split_correction(typo, correction)
+  if pool_offsets is not None:
+    return [backspaces + 128] + encode_offset(pool_offsets[text], pool_bytes)
+  return [backspaces + 128] + list(bytes(text, 'ascii')) + [0]
+
+
+def make_string_pool(
+    autocorrections: List[Tuple[str, str]]) -> Tuple[List[int], Dict[str, int]]:
+  """Makes a pool of the correction strings, sharing common suffixes.
+
+  Each string is stored null terminated. A string that is a suffix of another,
+  like "ing" of "thing", shares the other's storage.
+
+  Args:
+    autocorrections: List of (typo, correction) tuples.
+  Returns:
+    Tuple (pool, offsets) of the pool bytes and a dict mapping each string to
+    its offset in the pool.
+  """
+  strings = set(split_correction(*entry)[1] for entry in autocorrections)
+  pool = []
+  offsets = {}
+  # In descending order of the reversed strings, any string that is a suffix of
+  # another comes right after a string that it is a suffix of.
+  prev = None
+  for text in sorted(strings, key=lambda text: text[::-1], reverse=True):
+    if prev is not None and prev.endswith(text):
+      offsets[text] = offsets[prev] + len(prev) - len(text)
+    else:
+      offsets[text] = len(pool)
+      pool += list(bytes(text, 'ascii')) + [0]
+    prev = text
+  return pool, offsets
+
+
+def get_pool_bytes(pool: List[int]) -> int:
+  """Gets the number of bytes per offset into `pool`."""
+  return 2 if len(pool) <= 0x10000 else 3
+
+
+def serialize_double_array(
+    trie: Dict[str, Any],
+    pool_offsets: Optional[Dict[str, int]] = None,
+    pool_bytes: int = 2) -> Tuple[List[int], List[int], List[int]]:
+  """Serializes trie as a double array, readable by the C code.
+
+  Each trie node is a state. The transition from state s on symbol c (see
+  DOUBLE_ARRAY_SYMBOLS) goes to state t = base[s] + c, which is valid if
+  check[t] == s. The root is state 0. For a leaf, base is DOUBLE_ARRAY_LEAF
+  plus the offset of its data in the leaves array, in the same form as leaves
+  of the byte-oriented trie.
+
+  Args:
+    trie: Dict of dicts.
+    pool_offsets: Optional dict of correction string pool offsets.
+    pool_bytes: Int, 2 or 3, the number of bytes per pool offset.
+  Returns:
+    Tuple (base, check, leaves) of lists of ints.
+  Raises:
+    ValueError: if the trie is too large for 16-bit states, or an internal
+      node's base or the leaves array reaches DOUBLE_ARRAY_LEAF.
+  """
+  base = [0]
+  check = [DOUBLE_ARRAY_UNUSED]
+  leaves = []
+  leaf_offsets = {}
+
+  # skip[i] == i if slot i is free, otherwise it points to a later slot. It
+  # lets the search for free slots jump over runs of used slots.
+  skip = [0]
+
+  def grow(size: int) -> None:
+    if size >= DOUBLE_ARRAY_UNUSED:
+      raise ValueError('The double array exceeds 16-bit states.')
+    skip.extend(range(len(skip), size))
+    base.extend([0] * (size - len(base)))
+    check.extend([DOUBLE_ARRAY_UNUSED] * (size - len(check)))
+
+  def find_free(i: int) -> int:
+    """Finds the first free slot at or after i."""
+    free = i
+    while free < len(skip) and skip[free] != free:
+      free = skip[free]
+    while i < free and i < len(skip):  # Compress the path.
+      skip[i], i = free, skip[i]
+    return free
+
+  # Assign states in breadth first order, placing the children of each node at
+  # the smallest base where all of them fit.
+  queue = collections.deque([(0, trie)])
+  skip[0] = 1
+  while queue:
+    state, node = queue.popleft()
+    if 'LEAF' in node:
+      data = tuple(make_leaf_data(*node['LEAF'], pool_offsets, pool_bytes))
+      if data not in leaf_offsets:  # Identical leaves share their data.
+        leaf_offsets[data] = len(leaves)
+        leaves += data
+      base[state] = DOUBLE_ARRAY_LEAF | leaf_offsets[data]
+      continue
+
+    symbols = sorted(DOUBLE_ARRAY_SYMBOLS[c] for c in node)
+    # Try each base that puts the first child in a free slot, lowest first.
+    first = find_free(symbols[0])
+    while True:
+      b = first - symbols[0]
+      if b + symbols[-1] >= len(check):
+        grow(b + symbols[-1] + 1)
+      if all(check[b + c] == DOUBLE_ARRAY_UNUSED for c in symbols[1:]):
+        break
+      first = find_free(first + 1)
+
+    # Bases of internal nodes must be clear of the leaf flag, or the decoder
+    # would read the node as a leaf.
+    if b >= DOUBLE_ARRAY_LEAF:
+      raise ValueError('The double array exceeds 15-bit bases.')
+    base[state] = b
+    for c, child in sorted(node.items(),
+                           key=lambda item: DOUBLE_ARRAY_SYMBOLS[item[0]]):
+      check[b + DOUBLE_ARRAY_SYMBOLS[c]] = state
+      skip[b + DOUBLE_ARRAY_SYMBOLS[c]] = b + DOUBLE_ARRAY_SYMBOLS[c] + 1
+      queue.append((b + DOUBLE_ARRAY_SYMBOLS[c], child))
+
+  if len(leaves) >= DOUBLE_ARRAY_LEAF:
+    raise ValueError('The double array exceeds 16-bit states.')
+  return base, check, leaves
+
+
+def encode_offset(offset: int, num_bytes: int) -> List[int]:
+  """Encodes a node link or pool offset in little endian."""
+  if not (0 <= offset < 1 << (8 * num_bytes)):
+    raise ValueError(f'Offset {offset} does not fit in {num_bytes} bytes.')
+  return [(offset >> (8 * i)) & 255 for i in range(num_bytes)]
+
+
+def format_array(declaration: str, data: List[int]) -> str:
+  """Formats `data` as a C array initializer."""
+  return textwrap.fill('%s = {%s};' % (declaration, ', '.join(map(str, data))),
+                       width=80, subsequent_indent='  ')
 
 
 def write_generated_code(autocorrections: List[Tuple[str, str]],
-                         data: List[int],
+                         data_code: str,
                          file_name: str) -> None:
   """Writes autocorrection data as generated C code to `file_name`.
 
   Args:
     autocorrections: List of (typo, correction) tuples.
-    data: List of ints in 0-255, the serialized trie.
+    data_code: String, C code defining the serialized trie.
     file_name: String, path of the output C file.
   """
-  assert all(0 <= b <= 255 for b in data)
 
   def typo_len(e: Tuple[str, str]) -> int:
     return len(e[0])
@@ -287,28 +568,129 @@ def write_generated_code(autocorrections: List[Tuple[str, str]],
                    for typo, correction in autocorrections)),
     f'\n#define AUTOCORRECTION_MIN_LENGTH {len(min_typo)}  // "{min_typo}"\n',
     f'#define AUTOCORRECTION_MAX_LENGTH {len(max_typo)}  // "{max_typo}"\n\n',
-    textwrap.fill('static const uint8_t autocorrection_data[%d] PROGMEM = {%s};' % (
-      len(data), ', '.join(map(str, data))), width=80, subsequent_indent='  '),
+    data_code,
     '\n\n'])
 
   with open(file_name, 'wt') as f:
     f.write(generated_code)
 
 
+def trie_code(data: List[int], link_bytes: int, pool: List[int]) -> str:
+  """Makes C code for the byte-oriented trie."""
+  assert all(0 <= b <= 255 for b in data)
+  code = []
+  if link_bytes != 2:
+    code.append(f'#define AUTOCORRECTION_LINK_BYTES {link_bytes}')
+  code.append(format_array(
+      'static const uint8_t autocorrection_data[%d] PROGMEM' % len(data), data))
+  return '\n\n'.join(code + string_pool_code(pool))
+
+
+def double_array_code(base: List[int], check: List[int],
+                      leaves: List[int], pool: List[int]) -> str:
+  """Makes C code for the double-array trie."""
+  assert all(0 <= b <= 255 for b in leaves)
+  return '\n\n'.join([
+    '#define AUTOCORRECTION_DOUBLE_ARRAY',
+    format_array('static const uint16_t autocorrection_base[%d] PROGMEM'
+                 % len(base), base),
+    format_array('static const uint16_t autocorrection_check[%d] PROGMEM'
+                 % len(check), check),
+    format_array('static const uint8_t autocorrection_leaves[%d] PROGMEM'
+                 % len(leaves), leaves)] + string_pool_code(pool))
+
+
+def string_pool_code(pool: List[int]) -> List[str]:
+  """Makes C code for the correction string pool, if there is one."""
+  if not pool:
+    return []
+  pool_bytes = get_pool_bytes(pool)
+  return [
+    '#define AUTOCORRECTION_STRING_POOL' +
+    (f'\n#define AUTOCORRECTION_STRING_POOL_BYTES {pool_bytes}'
+     if pool_bytes != 2 else ''),
+    format_array('static const uint8_t autocorrection_strings[%d] PROGMEM'
+                 % len(pool), pool)]
+
+
 def get_default_h_file(dict_file: str) -> str:
   return os.path.join(os.path.dirname(dict_file), 'autocorrection_data.h')
 
 
 def main(argv):
-  dict_file = argv[1] if len(argv) > 1 else 'autocorrection_dict.txt'
-  h_file = argv[2] if len(argv) > 2 else get_default_h_file(dict_file)
-
-  autocorrections = parse_file(dict_file)
+  parser = argparse.ArgumentParser(
+      description='Makes autocorrection_data.h from a dictionary file.')
+  parser.add_argument('dict_file', nargs='?', default='autocorrection_dict.txt',
+                      help='autocorrection dictionary file')
+  parser.add_argument('h_file', nargs='?',
+                      help='output .h file, by default autocorrection_data.h '
+                      'next to the dictionary')
+  parser.add_argument('--format', choices=('trie', 'double-array'),
+                      default='trie', help='encoding of the trie')
+  parser.add_argument('--link-bytes', choices=('auto', '2', '3'),
+                      default='auto',
+                      help='bytes per node link of the trie format, by default '
+                      '2 unless the table exceeds 64 KB')
+  parser.add_argument('--string-pool', action='store_true',
+                      help='store corrections in a shared string pool')
+  parser.add_argument('--jobs', type=int, default=1,
+                      help='number of processes for checking typos against '
+                      'the English dictionary')
+  args = parser.parse_args(argv[1:])
+  h_file = args.h_file or get_default_h_file(args.dict_file)
+
+  autocorrections = parse_file(args.dict_file, max(args.jobs, 1))
   trie = make_trie(autocorrections)
-  data = serialize_trie(autocorrections, trie)
+  pool, pool_offsets = (make_string_pool(autocorrections) if args.string_pool
+                        else ([], None))
+  pool_bytes = get_pool_bytes(pool)
+
+  link_bytes = 2 if args.link_bytes == 'auto' else int(args.link_bytes)
+  try:
+    data = serialize_trie(autocorrections, trie, link_bytes, pool_offsets,
+                          pool_bytes)
+  except ValueError:
+    if args.link_bytes == 'auto':
+      link_bytes = 3
+      data = serialize_trie(autocorrections, trie, link_bytes, pool_offsets,
+                            pool_bytes)
+    else:
+      data = None
+  if data is None:
+    print(f'Error: The autocorrection table is too large for {link_bytes}-byte '
+          'links. Try --link-bytes=3 or reducing the autocorrection dict to '
+          'fewer entries.')
+    sys.exit(1)
+  trie_size = len(data) + len(pool)
+
+  try:
+    base, check, leaves = serialize_double_array(trie, pool_offsets,
+                                                 pool_bytes)
+    double_array_size = 2 * len(base) + 2 * len(check) + len(leaves) + len(pool)
+  except ValueError:
+    base = None
+  if args.format == 'double-array' and base is None:
+    print('Error: The autocorrection table is too large for the double-array '
+          'format. Try the default trie format.')
+    sys.exit(1)
+
   print(f'Processed %d autocorrection entries to table with %d bytes.'
-        % (len(autocorrections), len(data)))
-  write_generated_code(autocorrections, data, h_file)
+        % (len(autocorrections),
+           trie_size if args.format == 'trie' else double_array_size))
+  print(f'  trie:          %6d bytes (%d-byte links)' % (trie_size, link_bytes))
+  if base is None:
+    print('  double-array:  too large')
+  else:
+    print(f'  double-array:  %6d bytes (%d states)'
+          % (double_array_size, len(check)))
+  if pool:
+    print(f'  string pool:   %6d bytes, included in both' % len(pool))
+
+  if args.format == 'trie':
+    data_code = trie_code(data, link_bytes, pool)
+  else:
+    data_code = double_array_code(base, check, leaves, pool)
+  write_generated_code(autocorrections, data_code, h_file)
 
 
 if __name__ == '__main__':
@@ -0,0 +1,116 @@
+# Copyright 2025 Google LLC
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     https://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""Tests for make_autocorrection_data.py.
+
+Large dictionaries are serialized in each format, written as a header, and
+read back with the decoders of scan_autocorrection_corpus.py, which mirror
+autocorrection.c. Every typo must then trigger its own correction. Run it like
+
+$ python3 make_autocorrection_data_test.py
+"""
+
+import os.path
+import random
+import tempfile
+import unittest
+from typing import List, Tuple
+
+import make_autocorrection_data as make_data
+import scan_autocorrection_corpus as scan
+
+
+def make_dictionary(num_entries: int,
+                    typo_len: int) -> List[Tuple[str, str]]:
+  """Makes random typos of the same length, so none is a substring of another.
+
+  Each typo starts with a word break. The corrections share many suffixes, so
+  that the string pool has something to share.
+  """
+  rng = random.Random(num_entries)
+  letters = 'abcdefghijklmnopqrstuvwxyz'
+  typos = set()
+  while len(typos) < num_entries:
+    typos.add(':' + ''.join(rng.choice(letters) for _ in range(typo_len)))
+  return [(typo, typo[1:3] + rng.choice(('tion', 'ment', 'ing')))
+          for typo in sorted(typos)]
+
+
+def type_text(data: scan.AutocorrectionData,
+              text: str) -> Tuple[int, Tuple[int, str]]:
+  """Types `text`, returning the index of the first trigger and its leaf."""
+  typist = scan.Typist(data)
+  cursors = ()
+  for i, c in enumerate(text):
+    key = scan.KC_SPC if c == ':' else scan.KC_A + ord(c) - ord('a')
+    cursors, leaf, _ = typist.advance(cursors, key)
+    if leaf is not None:
+      return i, data.correction(leaf)
+  return -1, (0, '')
+
+
+class MakeAutocorrectionDataTest(unittest.TestCase):
+
+  def round_trip(self, autocorrections: List[Tuple[str, str]],
+                 double_array: bool, string_pool: bool) -> None:
+    trie = make_data.make_trie(autocorrections)
+    pool, pool_offsets = (make_data.make_string_pool(autocorrections)
+                          if string_pool else ([], None))
+    pool_bytes = make_data.get_pool_bytes(pool)
+    if double_array:
+      base, check, leaves = make_data.serialize_double_array(
+          trie, pool_offsets, pool_bytes)
+      data_code = make_data.double_array_code(base, check, leaves, pool)
+    else:
+      data = make_data.serialize_trie(autocorrections, trie, 3, pool_offsets,
+                                      pool_bytes)
+      data_code = make_data.trie_code(data, 3, pool)
+
+    with tempfile.TemporaryDirectory() as temp_dir:
+      h_file = os.path.join(temp_dir, 'autocorrection_data.h')
+      make_data.write_generated_code(autocorrections, data_code, h_file)
+      data = scan.AutocorrectionData(h_file)
+
+    for typo, correction in autocorrections:
+      with self.subTest(typo=typo):
+        self.assertEqual(type_text(data, typo),
+                         (len(typo) - 1,
+                          make_data.split_correction(typo, correction)))
+
+  def test_trie_round_trip(self):
+    autocorrections = make_dictionary(3000, 10)
+    for string_pool in (False, True):
+      with self.subTest(string_pool=string_pool):
+        self.round_trip(autocorrections, False, string_pool)
+
+  def test_double_array_round_trip(self):
+    # About 24000 states, most of the range of 15-bit bases.
+    autocorrections = make_dictionary(3000, 10)
+    for string_pool in (False, True):
+      with self.subTest(string_pool=string_pool):
+        self.round_trip(autocorrections, True, string_pool)
+
+  def test_double_array_too_large(self):
+    # Internal nodes would need bases of 0x8000 or more, which would collide
+    # with DOUBLE_ARRAY_LEAF.
+    autocorrections = make_dictionary(6000, 10)
+    pool, pool_offsets = make_data.make_string_pool(autocorrections)
+    with self.assertRaises(ValueError):
+      make_data.serialize_double_array(make_data.make_trie(autocorrections),
+                                       pool_offsets,
+                                       make_data.get_pool_bytes(pool))
+
+
+if __name__ == '__main__':
+  unittest.main()
@@ -0,0 +1,232 @@
+# Copyright 2025 Google LLC
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     https://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""Python program to make sentence_case_abbreviations.h.
+
+This program reads "sentence_case_abbreviations.txt" from the current directory
+and generates a C source file "sentence_case_abbreviations.h" with the
+abbreviations compiled into a serialized trie. Run this program without
+arguments like
+
+$ python3 make_sentence_case_abbreviations.py
+
+Or specify the abbreviations file and optionally the output .h file like
+
+$ python3 make_sentence_case_abbreviations.py abbrevs.txt somewhere/out.h
+
+Sentence Case uses the trie when SENTENCE_CASE_ABBREVIATIONS is defined in
+config.h, so that typing an abbreviation like "approx." is not taken as the
+end of a sentence. The trie is of the abbreviations written backwards, so that
+all of them are matched in one backwards walk over the recent keys, from the
+period to the start of the word.
+
+Each line of the file is one abbreviation, ending in a period. Letter case is
+ignored, and apostrophes and inner periods are allowed. Each abbreviation
+matches only at the start of a word, that is, after a key other than a letter,
+apostrophe, or period. Blank lines or lines starting with '#' are ignored.
+Example:
+
+    approx.
+    dept.
+    dr.
+    etc.
+    vs.
+
+The serialized trie uses the same node encoding as make_autocorrection_data.py.
+Matching the start of a word completes a match, so there are no leaf nodes.
+"""
+
+import argparse
+import os.path
+import sys
+import textwrap
+from typing import Any, Dict, Iterator, List, Tuple
+
+KC_A = 4
+KC_QUOT = 0x34
+KC_DOT = 0x37
+
+# Symbol for the start of a word. This must match WORD_START in
+# sentence_case.c. It is not the keycode of any typed key.
+WORD_START = 1
+WORD_START_CHAR = ' '
+
+ABBREVIATION_CHARS = {chr(ord('a') + i): KC_A + i for i in range(26)}
+ABBREVIATION_CHARS.update({"'": KC_QUOT, '.': KC_DOT})
+SYMBOLS = dict(ABBREVIATION_CHARS, **{WORD_START_CHAR: WORD_START})
+
+
+def parse_file_lines(file_name: str) -> Iterator[Tuple[int, str]]:
+  """Parses the abbreviations file, yielding (line number, abbreviation)."""
+  with open(file_name, 'rt') as f:
+    for line_number, line in enumerate(f, 1):
+      line = line.strip()
+      if line and line[0] != '#':
+        yield line_number, line.lower()
+
+
+def parse_file(file_name: str) -> List[str]:
+  """Parses and validates the abbreviations file.
+
+  Args:
+    file_name: String, path of the abbreviations file.
+  Returns:
+    Sorted list of unique abbreviations, lowercase.
+  """
+  abbreviations = set()
+  for line_number, abbreviation in parse_file_lines(file_name):
+    if not all(c in ABBREVIATION_CHARS for c in abbreviation):
+      print(f'Error:{line_number}: Abbreviation "{abbreviation}" has '
+            'characters other than letters, apostrophes, and periods.')
+      sys.exit(1)
+    if not abbreviation.endswith('.') or abbreviation == '.':
+      print(f'Error:{line_number}: Abbreviation "{abbreviation}" must be a '
+            'word ending in a period.')
+      sys.exit(1)
+    abbreviations.add(abbreviation)
+
+  if not abbreviations:
+    print(f'Error: {file_name} has no abbreviations.')
+    sys.exit(1)
+  return sorted(abbreviations)
+
+
+def make_trie(abbreviations: List[str]) -> Dict[str, Any]:
+  """Makes a trie of the abbreviations, each reversed and word-start marked.
+
+  Since every path ends in WORD_START_CHAR, which appears nowhere else, no
+  abbreviation's path is a prefix of another's and all leaves are empty.
+  """
+  trie = {}
+  for abbreviation in abbreviations:
+    node = trie
+    for c in (WORD_START_CHAR + abbreviation)[::-1]:
+      node = node.setdefault(c, {})
+  return trie
+
+
+def serialize_trie(trie: Dict[str, Any]) -> List[int]:
+  """Serializes the trie in a form readable by the C code.
+
+  Args:
+    trie: Dict of dicts.
+  Returns:
+    List of ints in the range 0-255.
+  Raises:
+    ValueError: if a link does not fit in 16 bits.
+  """
+  table = []
+
+  # Traverse trie in depth first order. Empty nodes, reached by WORD_START, are
+  # not serialized.
+  def traverse(trie_node: Dict[str, Any]) -> Dict[str, Any]:
+    if not trie_node:
+      return {'byte_offset': 0}
+    elif len(trie_node) == 1:  # Handle trie node with a single child.
+      c, trie_node = next(iter(trie_node.items()))
+      entry = {'chars': c, 'byte_offset': 0}
+      while len(trie_node) == 1:
+        c, trie_node = next(iter(trie_node.items()))
+        entry['chars'] += c
+      table.append(entry)
+      entry['links'] = [traverse(trie_node)]
+    else:  # Handle trie node with multiple children.
+      entry = {'chars': ''.join(sorted(trie_node.keys())), 'byte_offset': 0}
+      table.append(entry)
+      entry['links'] = [traverse(trie_node[c]) for c in entry['chars']]
+    return entry
+
+  traverse(trie)
+
+  def serialize(e: Dict[str, Any]) -> List[int]:
+    if len(e['links']) == 1:  # Handle a chain table entry.
+      return [SYMBOLS[c] for c in e['chars']] + [0]
+    else:  # Handle a branch table entry.
+      data = []
+      for c, link in zip(e['chars'], e['links']):
+        data += ([SYMBOLS[c] | (0 if data else 64)] +
+                 encode_offset(link['byte_offset']))
+      return data + [0]
+
+  byte_offset = 0
+  for e in table:  # To encode links, first compute byte offset of each entry.
+    e['byte_offset'] = byte_offset
+    byte_offset += len(serialize(e))
+
+  return [b for e in table for b in serialize(e)]  # Serialize final table.
+
+
+def encode_offset(offset: int) -> List[int]:
+  """Encodes a node link in 16-bit little endian."""
+  if not 0 <= offset < 1 << 16:
+    raise ValueError(f'Offset {offset} does not fit in 16 bits.')
+  return [offset & 255, offset >> 8]
+
+
+def write_generated_code(abbreviations: List[str], data: List[int],
+                         file_name: str) -> None:
+  """Writes the abbreviations trie as generated C code to `file_name`."""
+  assert all(0 <= b <= 255 for b in data)
+  max_abbreviation = max(abbreviations, key=len)
+  generated_code = ''.join([
+    '// Generated code.\n\n',
+    f'// Sentence Case abbreviations ({len(abbreviations)} entries):\n',
+    textwrap.fill(' '.join(abbreviations), width=80, initial_indent='//   ',
+                  subsequent_indent='//   '),
+    '\n\n// Keys to match, including the key before the abbreviation.\n',
+    '#define SENTENCE_CASE_ABBREVIATIONS_MAX_LENGTH '
+    f'{len(max_abbreviation) + 1}  // " {max_abbreviation}"\n\n',
+    textwrap.fill(
+        'static const uint8_t sentence_case_abbreviations_data[%d] PROGMEM = '
+        '{%s};' % (len(data), ', '.join(map(str, data))),
+        width=80, subsequent_indent='  '),
+    '\n\n'])
+
+  with open(file_name, 'wt') as f:
+    f.write(generated_code)
+
+
+def get_default_h_file(abbreviations_file: str) -> str:
+  return os.path.join(os.path.dirname(abbreviations_file),
+                      'sentence_case_abbreviations.h')
+
+
+def main(argv):
+  parser = argparse.ArgumentParser(
+      description='Makes sentence_case_abbreviations.h from a list of '
+      'abbreviations.')
+  parser.add_argument('abbreviations_file', nargs='?',
+                      default='sentence_case_abbreviations.txt',
+                      help='file of abbreviations, one per line')
+  parser.add_argument('h_file', nargs='?',
+                      help='output .h file, by default '
+                      'sentence_case_abbreviations.h next to the input')
+  args = parser.parse_args(argv[1:])
+  h_file = args.h_file or get_default_h_file(args.abbreviations_file)
+
+  abbreviations = parse_file(args.abbreviations_file)
+  try:
+    data = serialize_trie(make_trie(abbreviations))
+  except ValueError:
+    print('Error: The abbreviations table exceeds 64 KB. Please reduce the '
+          'list of abbreviations.')
+    sys.exit(1)
+
+  print(f'Processed {len(abbreviations)} abbreviations to table with '
+        f'{len(data)} bytes.')
+  write_generated_code(abbreviations, data, h_file)
+
+
+if __name__ == '__main__':
+  main(sys.argv)
@@ -46,10 +46,67 @@
 #ifndef ORBITAL_MOUSE_INTERVAL_MS
 #define ORBITAL_MOUSE_INTERVAL_MS 16
 #endif  // ORBITAL_MOUSE_INTERVAL_MS
+#ifndef ORBITAL_MOUSE_NUM_ANGLES
+#define ORBITAL_MOUSE_NUM_ANGLES 64
+#endif  // ORBITAL_MOUSE_NUM_ANGLES
+#ifdef ORBITAL_MOUSE_VARIABLE_RATE
+// With variable rate, the task updates as often as the host polls the mouse,
+// integrating over the actual elapsed time rather than fixed intervals.
+#ifndef ORBITAL_MOUSE_MIN_INTERVAL_MS
+#ifdef USB_POLLING_INTERVAL_MS
+#define ORBITAL_MOUSE_MIN_INTERVAL_MS USB_POLLING_INTERVAL_MS
+#else
+#define ORBITAL_MOUSE_MIN_INTERVAL_MS 1
+#endif  // USB_POLLING_INTERVAL_MS
+#endif  // ORBITAL_MOUSE_MIN_INTERVAL_MS
+#ifndef ORBITAL_MOUSE_MAX_STEP_MS
+#define ORBITAL_MOUSE_MAX_STEP_MS (4 * (ORBITAL_MOUSE_INTERVAL_MS))
+#endif  // ORBITAL_MOUSE_MAX_STEP_MS
+#endif  // ORBITAL_MOUSE_VARIABLE_RATE
+#ifndef ORBITAL_MOUSE_PROFILES
+// Speeds are Q6.2 values in pixels per interval, durations are in intervals.
+#define ORBITAL_MOUSE_PROFILES                                        \
+  {/* Precision: slow, easing up to double speed over a second. */    \
+   {8, {{ORBITAL_MOUSE_CUBIC, 64, 16}}},                              \
+   /* Normal: close to the default speed curve. */                     \
+   {24, {{ORBITAL_MOUSE_CUBIC, 40, 24}, {ORBITAL_MOUSE_CUBIC, 40, 66}}}, \
+   /* Flick: a fast start that quickly rises to a high top speed. */   \
+   {48, {{ORBITAL_MOUSE_EXP, 24, 200}}}}
+#endif  // ORBITAL_MOUSE_PROFILES
 
 #if !(0 <= ORBITAL_MOUSE_RADIUS && ORBITAL_MOUSE_RADIUS <= 63)
 #error "Invalid ORBITAL_MOUSE_RADIUS. Value must be in [0, 63]."
 #endif
+#if ORBITAL_MOUSE_NUM_ANGLES == 64
+#define ANGLE_PHASE_SHIFT 8
+#elif ORBITAL_MOUSE_NUM_ANGLES == 256
+#define ANGLE_PHASE_SHIFT 6
+#define SIN_INTERP_BITS 1
+#elif ORBITAL_MOUSE_NUM_ANGLES == 1024
+#define ANGLE_PHASE_SHIFT 4
+#define SIN_INTERP_BITS 3
+#else
+#error "Invalid ORBITAL_MOUSE_NUM_ANGLES. Value must be 64, 256, or 1024."
+#endif
+#if defined(ORBITAL_MOUSE_VARIABLE_RATE) && \
+    !(1 <= ORBITAL_MOUSE_MIN_INTERVAL_MS &&  \
+      ORBITAL_MOUSE_MIN_INTERVAL_MS <= ORBITAL_MOUSE_MAX_STEP_MS && \
+      ORBITAL_MOUSE_MAX_STEP_MS <= 64)
+#error "Invalid ORBITAL_MOUSE_MIN_INTERVAL_MS or ORBITAL_MOUSE_MAX_STEP_MS."
+#endif
+
+#if defined(ORBITAL_MOUSE_ACCEL_PROFILES) &&      \
+    (!defined(EECONFIG_USER_DATA_SIZE) ||         \
+     EECONFIG_USER_DATA_SIZE <                    \
+         ORBITAL_MOUSE_EEPROM_OFFSET + ORBITAL_MOUSE_EEPROM_SIZE)
+#error "orbital_mouse: Define EECONFIG_USER_DATA_SIZE >= ORBITAL_MOUSE_EEPROM_OFFSET + ORBITAL_MOUSE_EEPROM_SIZE in config.h."
+#endif
+
+// Adaptive Term saves its block at the start of the user data block.
+#if defined(ORBITAL_MOUSE_ACCEL_PROFILES) && defined(ADAPTIVE_TERM_ENABLE) && \
+    ORBITAL_MOUSE_EEPROM_OFFSET < ADAPTIVE_TERM_EEPROM_SIZE
+#error "orbital_mouse: ORBITAL_MOUSE_EEPROM_OFFSET overlaps Adaptive Term's EEPROM block. Set it >= ADAPTIVE_TERM_EEPROM_SIZE."
+#endif
 
 #if !defined(IS_MOUSE_KEYCODE)
 // Attempt to detect out-of-date QMK installation, which would fail with
@@ -64,7 +121,7 @@
 
 enum {
   /** Number of distinct angles. */
-  NUM_ANGLES = 64,
+  NUM_ANGLES = ORBITAL_MOUSE_NUM_ANGLES,
   /** Number of intervals in speed curve table. */
   NUM_SPEED_CURVE_INTERVALS = 16,
   /** Orbit radius in pixels as a Q6.2 value. */
@@ -81,8 +138,33 @@ enum {
   /** Double click delay in units of intervals. */
   DOUBLE_CLICK_DELAY_INTERVALS =
       (ORBITAL_MOUSE_DBL_DELAY_MS) / (ORBITAL_MOUSE_INTERVAL_MS),
+#ifdef MOUSE_EXTENDED_REPORT
+  /** Largest x or y report delta, per the HID report descriptor. */
+  REPORT_XY_MAX = 32767,
+#else
+  REPORT_XY_MAX = 127,
+#endif  // MOUSE_EXTENDED_REPORT
+#ifdef ORBITAL_MOUSE_VARIABLE_RATE
+  /** Duration of one speed curve interval in ms. */
+  SPEED_CURVE_INTERVAL_MS = 16 * (ORBITAL_MOUSE_INTERVAL_MS),
+  /** Units of time step per interval. */
+  TIME_SCALE = ORBITAL_MOUSE_INTERVAL_MS,
+#else
+  TIME_SCALE = 1,
+#endif  // ORBITAL_MOUSE_VARIABLE_RATE
 };
 
+#if defined(ORBITAL_MOUSE_VARIABLE_RATE) || defined(MOUSE_EXTENDED_REPORT)
+// With variable rate, displacements are accumulated in units TIME_SCALE times
+// finer, so that a time step of `dt` ms adds dt times the per-interval amount
+// without rounding. With 16-bit reports, a frame may move more than the 128
+// pixels that fit in Q7.8.
+typedef int32_t displacement_t;
+#else
+typedef int16_t displacement_t;
+#endif  // defined(ORBITAL_MOUSE_VARIABLE_RATE) ||
+        // defined(MOUSE_EXTENDED_REPORT)
+
 // Masks for the `held_keys` bitfield.
 enum {
   HELD_U = 1,
@@ -103,18 +185,21 @@ static struct {
   const uint8_t* speed_curve;
   // Time when the Orbital Mouse task function should next run.
   uint16_t timer;
-  // Fractional displacement of the cursor as Q7.8 values.
-  int16_t x;
-  int16_t y;
-  // Fractional displacement of the mouse wheel as Q9.6 values.
-  int16_t wheel_x;
-  int16_t wheel_y;
+  // Fractional displacement of the cursor as Q7.8 values, times TIME_SCALE.
+  displacement_t x;
+  displacement_t y;
+  // Fractional displacement of the mouse wheel as Q9.6 values, times
+  // TIME_SCALE.
+  displacement_t wheel_x;
+  displacement_t wheel_y;
   // Current cursor movement speed as a Q9.6 value.
   int16_t speed;
   // Bitfield tracking which movement keys are currently held.
   uint8_t held_keys;
-  // Cursor movement time, counted in number of intervals.
-  uint8_t move_t;
+  // Cursor movement time, counted in number of intervals, or in ms with
+  // variable rate. With acceleration profiles, it is instead nonzero once
+  // moving, plus the ms not yet stepped with variable rate.
+  uint16_t move_t;
   // Cursor movement direction, 1 => forward, -1 => backward.
   int8_t move_dir;
   // Steering direction, 1 => counter-clockwise, -1 => clockwise.
@@ -130,8 +215,197 @@ static struct {
   uint8_t double_click_frame;
   // When true, movement and turning are slower.
   bool slow;
+#ifdef ORBITAL_MOUSE_VARIABLE_RATE
+  // Time of the last update.
+  uint16_t last_update;
+  // Time of the last double click step.
+  uint16_t double_click_timer;
+  // Heading angle remainder, in units of 1 / TIME_SCALE of the Q6.8 angle.
+  int16_t angle_rem;
+#endif  // ORBITAL_MOUSE_VARIABLE_RATE
+  // Start of the current one-second window for measuring the report rate.
+  uint16_t rate_timer;
+  // Number of reports sent in the current window.
+  uint16_t report_count;
+  // Number of reports sent in the last complete window.
+  uint16_t report_rate;
+#ifdef ORBITAL_MOUSE_ACCEL_PROFILES
+  // Speed while evaluating an acceleration profile, as Q9.6 values scaled by
+  // 2^16: the current speed, its forward differences, and the segment's end.
+  int32_t accel_speed;
+  int32_t accel_d1;
+  int32_t accel_d2;
+  int32_t accel_d3;
+  int32_t accel_target;
+  // Current segment of the profile and intervals left in it.
+  uint8_t accel_segment;
+  uint8_t accel_frames_left;
+  // For exponential segments, the shift giving the time constant.
+  uint8_t accel_shift;
+#endif  // ORBITAL_MOUSE_ACCEL_PROFILES
 } state = {.speed_curve = init_speed_curve};
 
+#ifdef ORBITAL_MOUSE_ACCEL_PROFILES
+static const orbital_mouse_profile_t default_profiles[] PROGMEM =
+    ORBITAL_MOUSE_PROFILES;
+
+_Static_assert(sizeof(default_profiles) / sizeof(orbital_mouse_profile_t) ==
+               ORBITAL_MOUSE_NUM_PROFILES,
+               "orbital_mouse: ORBITAL_MOUSE_PROFILES must have "
+               "ORBITAL_MOUSE_NUM_PROFILES profiles.");
+
+// Layout of the EEPROM user data block, from ORBITAL_MOUSE_EEPROM_OFFSET. The
+// table dimensions are saved so that profiles with a different layout are
+// discarded rather than misread.
+typedef struct {
+  uint8_t num_profiles;
+  uint8_t num_segments;
+  uint8_t selected;
+  orbital_mouse_profile_t profiles[ORBITAL_MOUSE_NUM_PROFILES];
+} saved_profiles_t;
+
+_Static_assert(sizeof(saved_profiles_t) == ORBITAL_MOUSE_EEPROM_SIZE,
+               "orbital_mouse: Unexpected padding in saved_profiles_t.");
+
+static saved_profiles_t profiles = {0};
+
+static void save_profiles(void) {
+  eeconfig_update_user_datablock(&profiles, ORBITAL_MOUSE_EEPROM_OFFSET,
+                                 sizeof(profiles));
+}
+
+/** Loads the profiles from EEPROM, or the defaults if none are saved. */
+static void init_profiles(void) {
+  static bool initialized = false;
+  if (initialized) {
+    return;
+  }
+  initialized = true;
+
+  eeconfig_read_user_datablock(&profiles, ORBITAL_MOUSE_EEPROM_OFFSET,
+                               sizeof(profiles));
+  if (profiles.num_profiles != ORBITAL_MOUSE_NUM_PROFILES ||
+      profiles.num_segments != ORBITAL_MOUSE_PROFILE_SEGMENTS ||
+      profiles.selected >= ORBITAL_MOUSE_NUM_PROFILES) {
+    profiles.num_profiles = ORBITAL_MOUSE_NUM_PROFILES;
+    profiles.num_segments = ORBITAL_MOUSE_PROFILE_SEGMENTS;
+    profiles.selected = ORBITAL_MOUSE_DEFAULT_PROFILE;
+    memcpy_P(profiles.profiles, default_profiles, sizeof(default_profiles));
+    save_profiles();
+  }
+}
+
+/** Sets up evaluation of the current segment, from the current speed. */
+static void start_accel_segment(void) {
+  const orbital_mouse_profile_t* profile =
+      &profiles.profiles[profiles.selected];
+  const orbital_mouse_segment_t* segment = NULL;
+  if (state.accel_segment < ORBITAL_MOUSE_PROFILE_SEGMENTS) {
+    segment = &profile->segments[state.accel_segment];
+  }
+  if (segment == NULL || segment->frames == 0) {
+    // Past the last segment, the speed holds.
+    state.accel_frames_left = 0;
+    state.accel_d1 = state.accel_d2 = state.accel_d3 = 0;
+    return;
+  }
+
+  const uint8_t n = segment->frames;
+  state.accel_frames_left = n;
+  state.accel_target = ((int32_t)segment->speed * 16) << 16;
+  const int32_t delta = state.accel_target - state.accel_speed;
+
+  if (segment->shape == ORBITAL_MOUSE_EXP) {
+    // Approach the target with a time constant of about n / 4 intervals.
+    state.accel_shift = 0;
+    while ((8 << state.accel_shift) <= n) {
+      ++state.accel_shift;
+    }
+  } else if (n < 4) {
+    // Too short for a curve, step linearly.
+    state.accel_d1 = delta / n;
+    state.accel_d2 = state.accel_d3 = 0;
+  } else {
+    // Ease in and out along the cubic delta * (3 u^2 - 2 u^3), u = t / n,
+    // evaluated by forward differences.
+    const int32_t n2 = (int32_t)n * n;
+    const int32_t a = 3 * delta / n2;
+    const int32_t b = -2 * (delta / n2) / n;
+    state.accel_d1 = a + b;
+    state.accel_d2 = 2 * a + 6 * b;
+    state.accel_d3 = 6 * b;
+  }
+}
+
+/** Starts evaluating the selected profile at its initial speed. */
+static void reset_accel(void) {
+  init_profiles();
+  state.accel_speed =
+      ((int32_t)profiles.profiles[profiles.selected].speed * 16) << 16;
+  state.accel_segment = 0;
+  start_accel_segment();
+}
+
+/** Advances the profile by one interval. */
+static void step_accel(void) {
+  if (!state.accel_frames_left) {
+    return;
+  }
+  const orbital_mouse_profile_t* profile =
+      &profiles.profiles[profiles.selected];
+  if (profile->segments[state.accel_segment].shape == ORBITAL_MOUSE_EXP) {
+    state.accel_speed +=
+        (state.accel_target - state.accel_speed) >> state.accel_shift;
+  } else {
+    state.accel_speed += state.accel_d1;
+    state.accel_d1 += state.accel_d2;
+    state.accel_d2 += state.accel_d3;
+  }
+  if (--state.accel_frames_left == 0) {
+    // Land exactly on the segment's end speed and go to the next segment.
+    state.accel_speed = state.accel_target;
+    ++state.accel_segment;
+    start_accel_segment();
+  }
+}
+
+void set_orbital_mouse_profile(uint8_t profile) {
+  init_profiles();
+  if (profile < ORBITAL_MOUSE_NUM_PROFILES && profile != profiles.selected) {
+    profiles.selected = profile;
+    save_profiles();
+    state.move_t = 0;  // Restart acceleration with the new profile.
+  }
+}
+
+uint8_t get_orbital_mouse_profile(void) {
+  init_profiles();
+  return profiles.selected;
+}
+
+void set_orbital_mouse_profile_data(uint8_t i,
+                                    const orbital_mouse_profile_t* profile) {
+  init_profiles();
+  if (i >= ORBITAL_MOUSE_NUM_PROFILES) {
+    return;
+  }
+  if (profile != NULL) {
+    profiles.profiles[i] = *profile;
+  } else {
+    memcpy_P(&profiles.profiles[i], &default_profiles[i],
+             sizeof(orbital_mouse_profile_t));
+  }
+  save_profiles();
+  state.move_t = 0;
+}
+
+const orbital_mouse_profile_t* get_orbital_mouse_profile_data(uint8_t i) {
+  init_profiles();
+  return (i < ORBITAL_MOUSE_NUM_PROFILES) ? &profiles.profiles[i] : NULL;
+}
+#endif  // ORBITAL_MOUSE_ACCEL_PROFILES
+
+#if ORBITAL_MOUSE_NUM_ANGLES == 64
 /**
  * Fixed-point sine with specified amplitude and phase.
  *
@@ -139,7 +413,7 @@ static struct {
  * @param phase Value in [0, 63].
  * @returns Result as a Q6.8 value.
  */
-static int16_t scaled_sin(uint8_t amplitude, uint8_t phase) {
+static int16_t scaled_sin(uint8_t amplitude, uint16_t phase) {
   // Look up table covers half a cycle of a sine wave.
   static const uint8_t lut[NUM_ANGLES / 2] PROGMEM = {
       0,   25,  50,  74,  98,  120, 142, 162, 180, 197, 212,
@@ -150,16 +424,87 @@ static int16_t scaled_sin(uint8_t amplitude, uint8_t phase) {
         * pgm_read_byte(lut + (phase & (NUM_ANGLES / 2 - 1))) + 2) >> 2);
   return ((NUM_ANGLES / 2) & phase) == 0 ? value : -value;
 }
+#else
+/**
+ * Fixed-point sine with specified amplitude and phase.
+ *
+ * A quarter-wave table in 32 steps is linearly interpolated, so that the
+ * table stays the same size for any number of angles.
+ *
+ * @param amplitude Nonnegative Q6.2 value.
+ * @param phase Value in [0, NUM_ANGLES - 1].
+ * @returns Result as a Q6.8 value.
+ */
+static int16_t scaled_sin(uint8_t amplitude, uint16_t phase) {
+  // Look up table covers a quarter cycle of a sine wave, as Q0.16 values with
+  // sin(pi/2) = 1 rounded down to 65535.
+  static const uint16_t lut[33] PROGMEM = {
+      0,     3216,  6424,  9616,  12785, 15924, 19024, 22078, 25080,
+      28020, 30893, 33692, 36410, 39040, 41576, 44011, 46341, 48559,
+      50660, 52639, 54491, 56212, 57798, 59244, 60547, 61705, 62714,
+      63572, 64277, 64827, 65220, 65457, 65535};
+  // Fold the phase into the first quarter cycle, in [0, NUM_ANGLES / 4].
+  uint16_t q = phase & (NUM_ANGLES / 2 - 1);
+  if (q > NUM_ANGLES / 4) {
+    q = NUM_ANGLES / 2 - q;
+  }
+  const uint8_t i = q >> SIN_INTERP_BITS;
+  const uint8_t frac = q & ((1 << SIN_INTERP_BITS) - 1);
+  uint16_t y = pgm_read_word(lut + i);
+  if (frac) {
+    y += (uint16_t)(((uint32_t)(pgm_read_word(lut + i + 1) - y) * frac)
+                    >> SIN_INTERP_BITS);
+  }
+  // amplitude is Q6.2 and y is Q0.16. Shift down by 10 so the result is Q6.8.
+  int16_t value = (int16_t)(((uint32_t)amplitude * y + (1 << 9)) >> 10);
+  return ((NUM_ANGLES / 2) & phase) == 0 ? value : -value;
+}
+#endif  // ORBITAL_MOUSE_NUM_ANGLES == 64
 
 /** Computes fixed-point cosine. */
-static int16_t scaled_cos(uint8_t amplitude, uint8_t phase) {
+static int16_t scaled_cos(uint8_t amplitude, uint16_t phase) {
   return scaled_sin(amplitude, phase + (NUM_ANGLES / 4));
 }
 
+/** Converts a Q6.8 heading angle to a phase in units of 1 / NUM_ANGLES. */
+static uint16_t angle_phase(uint16_t angle) {
+  return angle >> ANGLE_PHASE_SHIFT;
+}
+
+/**
+ * Takes the whole pixels of a cursor displacement for a report.
+ *
+ * The report delta is limited to what the report can hold, 8 or 16 bits.
+ * The rest of the displacement, the fractional part and any excess up to
+ * another report, is left in `*accum` to be carried over to later reports.
+ */
+static mouse_xy_report_t take_report_xy(displacement_t* accum) {
+  displacement_t delta = *accum / (256 * TIME_SCALE);
+  if (delta > REPORT_XY_MAX) {
+    delta = REPORT_XY_MAX;
+  } else if (delta < -REPORT_XY_MAX) {
+    delta = -REPORT_XY_MAX;
+  }
+  *accum -= delta * (256 * TIME_SCALE);
+  // Carry over at most another full report, so that the pointer doesn't keep
+  // moving long after the keys are released.
+  const displacement_t max_carry = (displacement_t)REPORT_XY_MAX
+                                 * (256 * TIME_SCALE);
+  if (*accum > max_carry) {
+    *accum = max_carry;
+  } else if (*accum < -max_carry) {
+    *accum = -max_carry;
+  }
+  return (mouse_xy_report_t)delta;
+}
+
 /** Wakes the Orbital Mouse task.  */
 static void wake_orbital_mouse_task(void) {
   if (!state.timer) {
     state.timer = timer_read() | 1;
+#ifdef ORBITAL_MOUSE_VARIABLE_RATE
+    state.last_update = state.timer - ORBITAL_MOUSE_MIN_INTERVAL_MS;
+#endif  // ORBITAL_MOUSE_VARIABLE_RATE
   }
 }
 
@@ -210,16 +555,24 @@ void set_orbital_mouse_speed_curve(const uint8_t* speed_curve) {
   state.speed_curve = (speed_curve != NULL) ? speed_curve : init_speed_curve;
 }
 
+uint16_t get_orbital_mouse_report_rate(void) {
+  return state.report_rate;
+}
+
 uint8_t get_orbital_mouse_angle(void) {
-  return (state.angle >> 8) & (NUM_ANGLES - 1);
+  return (state.angle >> 8) & 63;  // In the API, angles are always in 0-63.
 }
 
 static void set_orbital_mouse_angle_fractional(uint16_t angle) {
-  state.x += scaled_sin(RADIUS_Q6_2, state.angle >> 8);
-  state.y += scaled_cos(RADIUS_Q6_2, state.angle >> 8);
+  state.x += (displacement_t)scaled_sin(RADIUS_Q6_2, angle_phase(state.angle))
+           * TIME_SCALE;
+  state.y += (displacement_t)scaled_cos(RADIUS_Q6_2, angle_phase(state.angle))
+           * TIME_SCALE;
   state.angle = angle;
-  state.x -= scaled_sin(RADIUS_Q6_2, angle >> 8);
-  state.y -= scaled_cos(RADIUS_Q6_2, angle >> 8);
+  state.x -= (displacement_t)scaled_sin(RADIUS_Q6_2, angle_phase(angle))
+           * TIME_SCALE;
+  state.y -= (displacement_t)scaled_cos(RADIUS_Q6_2, angle_phase(angle))
+           * TIME_SCALE;
   wake_orbital_mouse_task();
 }
 
@@ -263,6 +616,10 @@ bool process_orbital_mouse(uint16_t keycode, keyrecord_t* record) {
       case OM_DBLS:
         if (record->event.pressed) {
           state.double_click_frame = 1;
+#ifdef ORBITAL_MOUSE_VARIABLE_RATE
+          state.double_click_timer =
+              timer_read() - ORBITAL_MOUSE_INTERVAL_MS;
+#endif  // ORBITAL_MOUSE_VARIABLE_RATE
         }
         break;
       case OM_SLOW:
@@ -273,6 +630,19 @@ bool process_orbital_mouse(uint16_t keycode, keyrecord_t* record) {
           select_mouse_button(keycode - OM_SEL1);
         }
         return false;
+#ifdef ORBITAL_MOUSE_ACCEL_PROFILES
+      case OM_PNXT:
+        if (record->event.pressed) {
+          set_orbital_mouse_profile(
+              (get_orbital_mouse_profile() + 1) % ORBITAL_MOUSE_NUM_PROFILES);
+        }
+        return false;
+      case OM_PRF1 ... OM_PRF3:
+        if (record->event.pressed) {
+          set_orbital_mouse_profile(keycode - OM_PRF1);
+        }
+        return false;
+#endif  // ORBITAL_MOUSE_ACCEL_PROFILES
     }
   }
 
@@ -298,10 +668,54 @@ void orbital_mouse_task(void) {
     return;
   }
 
+#ifdef ORBITAL_MOUSE_VARIABLE_RATE
+  // Time step in ms since the last update, limited so that a stall in the
+  // main loop doesn't make the cursor jump.
+  const uint16_t elapsed = now - state.last_update;
+  const uint8_t dt =
+      elapsed < ORBITAL_MOUSE_MAX_STEP_MS ? elapsed : ORBITAL_MOUSE_MAX_STEP_MS;
+  state.last_update = now;
+#else
+  const uint8_t dt = 1;  // Time step, one interval.
+#endif  // ORBITAL_MOUSE_VARIABLE_RATE
+
   bool active = false;
 
   // Update position if moving.
   if (state.move_dir) {
+#if defined(ORBITAL_MOUSE_ACCEL_PROFILES)
+    // Update speed from the acceleration profile, one interval at a time.
+    if (state.move_t == 0) {
+      reset_accel();
+      state.move_t = 1;
+    } else {
+#ifdef ORBITAL_MOUSE_VARIABLE_RATE
+      for (state.move_t += dt; state.move_t > ORBITAL_MOUSE_INTERVAL_MS;
+           state.move_t -= ORBITAL_MOUSE_INTERVAL_MS) {
+        step_accel();
+      }
+#else
+      step_accel();
+#endif  // ORBITAL_MOUSE_VARIABLE_RATE
+    }
+    state.speed = (int16_t)(state.accel_speed >> 16);
+#elif defined(ORBITAL_MOUSE_VARIABLE_RATE)
+    // Update speed, interpolated from speed_curve.
+    const uint16_t end_ms =
+        SPEED_CURVE_INTERVAL_MS * (NUM_SPEED_CURVE_INTERVALS - 1);
+    if (state.move_t < end_ms) {
+      const uint8_t i = state.move_t / SPEED_CURVE_INTERVAL_MS;
+      const int32_t t = state.move_t - i * SPEED_CURVE_INTERVAL_MS;
+      state.speed = (int16_t)state.speed_curve[i] * 16
+          + (int16_t)(t * 16 * ((int16_t)state.speed_curve[i + 1]
+                                - (int16_t)state.speed_curve[i])
+                      / SPEED_CURVE_INTERVAL_MS);
+      state.move_t += dt;
+    } else {
+      state.speed =
+          (int16_t)state.speed_curve[NUM_SPEED_CURVE_INTERVALS - 1] * 16;
+    }
+#else
     // Update speed, interpolated from speed_curve.
     if (state.move_t <= 16 * (NUM_SPEED_CURVE_INTERVALS - 1)) {
       if (state.move_t == 0) {
@@ -314,14 +728,17 @@ void orbital_mouse_task(void) {
 
       ++state.move_t;
     }
+#endif  // defined(ORBITAL_MOUSE_ACCEL_PROFILES)
     // Round and cast from Q9.6 to Q6.2.
     uint8_t speed = (state.speed + 8) / 16;
     if (state.slow) {
       speed = ((uint16_t)speed) * (1 + (uint16_t)SLOW_MOVE_FACTOR_Q_8) >> 8;
     }
 
-    state.x -= state.move_dir * scaled_sin(speed, state.angle >> 8);
-    state.y -= state.move_dir * scaled_cos(speed, state.angle >> 8);
+    state.x -= (displacement_t)(state.move_dir * dt)
+             * scaled_sin(speed, angle_phase(state.angle));
+    state.y -= (displacement_t)(state.move_dir * dt)
+             * scaled_cos(speed, angle_phase(state.angle));
     active = true;
   }
 
@@ -331,19 +748,36 @@ void orbital_mouse_task(void) {
     if (state.steer_dir == -1) {
       angle_step = -angle_step;
     }
+#ifdef ORBITAL_MOUSE_VARIABLE_RATE
+    const int32_t turn = (int32_t)angle_step * dt + state.angle_rem;
+    angle_step = turn / TIME_SCALE;
+    state.angle_rem = turn - (int32_t)angle_step * TIME_SCALE;
+#endif  // ORBITAL_MOUSE_VARIABLE_RATE
     set_orbital_mouse_angle_fractional(state.angle + angle_step);
     active = true;
   }
 
   // Update mouse wheel if active.
   if (state.wheel_x_dir || state.wheel_y_dir) {
-    state.wheel_x -= state.wheel_x_dir * WHEEL_SPEED_Q2_6;
-    state.wheel_y += state.wheel_y_dir * WHEEL_SPEED_Q2_6;
+    state.wheel_x -= (displacement_t)(state.wheel_x_dir * dt)
+                   * WHEEL_SPEED_Q2_6;
+    state.wheel_y += (displacement_t)(state.wheel_y_dir * dt)
+                   * WHEEL_SPEED_Q2_6;
     active = true;
   }
 
   // Update double click action.
+#ifdef ORBITAL_MOUSE_VARIABLE_RATE
+  // Double click steps are kept at the fixed interval, so that each press and
+  // release lasts long enough for the host to see it.
+  if (state.double_click_frame &&
+      timer_elapsed(state.double_click_timer) < ORBITAL_MOUSE_INTERVAL_MS) {
+    active = true;
+  } else if (state.double_click_frame) {
+    state.double_click_timer = now;
+#else
   if (state.double_click_frame) {
+#endif  // ORBITAL_MOUSE_VARIABLE_RATE
     ++state.double_click_frame;
     const uint8_t mask = 1 << state.selected_button;
     switch (state.double_click_frame) {
@@ -359,19 +793,42 @@ void orbital_mouse_task(void) {
     active = true;
   }
 
+  // Set whole part of movement deltas in report and retain fractional parts.
+  state.report.x = take_report_xy(&state.x);
+  state.report.y = take_report_xy(&state.y);
+  state.report.h = state.wheel_x / (64 * TIME_SCALE);
+  state.report.v = state.wheel_y / (64 * TIME_SCALE);
+  state.wheel_x -= (displacement_t)state.report.h * (64 * TIME_SCALE);
+  state.wheel_y -= (displacement_t)state.report.v * (64 * TIME_SCALE);
+  // Stay awake while there are whole pixels left over from clamping.
+  if (state.x / (256 * TIME_SCALE) || state.y / (256 * TIME_SCALE)) {
+    active = true;
+  }
+
   // Schedule when task should run again, or go to sleep if inactive.
+#ifdef ORBITAL_MOUSE_VARIABLE_RATE
+  // Rounding up to odd as below would halve a 1 ms rate, so only a timer of 0
+  // (meaning asleep) is bumped.
+  const uint16_t next = now + ORBITAL_MOUSE_MIN_INTERVAL_MS;
+  state.timer = active ? (next ? next : 1) : 0;
+#else
   state.timer = active ? ((now + ORBITAL_MOUSE_INTERVAL_MS) | 1) : 0;
+#endif  // ORBITAL_MOUSE_VARIABLE_RATE
 
-  // Set whole part of movement deltas in report and retain fractional parts.
-  state.report.x = state.x / 256;
-  state.report.y = state.y / 256;
-  state.x -= (int16_t)state.report.x * 256;
-  state.y -= (int16_t)state.report.y * 256;
-  state.report.h = state.wheel_x / 64;
-  state.report.v = state.wheel_y / 64;
-  state.wheel_x -= (int16_t)state.report.h * 64;
-  state.wheel_y -= (int16_t)state.report.v * 64;
   host_mouse_send(&state.report);
+
+  // Count reports in one-second windows. A window spanning an idle period
+  // is discarded rather than counted.
+  const uint16_t window_ms = now - state.rate_timer;
+  if (window_ms >= 2000) {
+    state.rate_timer = now;
+    state.report_count = 0;
+  } else if (window_ms >= 1000) {
+    state.report_rate = state.report_count;
+    state.rate_timer += 1000;
+    state.report_count = 0;
+  }
+  ++state.report_count;
 }
 
 #endif
@@ -42,6 +42,10 @@
 
 #include "quantum.h"
 
+#ifdef ADAPTIVE_TERM_ENABLE
+#include "adaptive_term.h"
+#endif  // ADAPTIVE_TERM_ENABLE
+
 /**
  * Handler function for Orbital Mouse.
  *
@@ -79,9 +83,111 @@ void orbital_mouse_task(void);
  *
  * @param speed_curve Pointer to an array of size 16. If NULL, the speed curve
  *                    defined by ORBITAL_MOUSE_SPEED_CURVE is set.
+ *
+ * @note With `ORBITAL_MOUSE_ACCEL_PROFILES`, the speed curve is unused.
  */
 void set_orbital_mouse_speed_curve(const uint8_t* speed_curve);
 
+/**
+ * Acceleration profiles.
+ *
+ * Define `ORBITAL_MOUSE_ACCEL_PROFILES` in config.h to replace the speed curve
+ * with several named acceleration profiles, stored in EEPROM and switched with
+ * the `OM_PNXT` and `OM_PRF1`-`OM_PRF3` keys. By default, the profiles are
+ * "precision," "normal," and "flick." Each profile has an initial speed,
+ * followed by up to ORBITAL_MOUSE_PROFILE_SEGMENTS segments, each easing the
+ * speed to a target over a number of intervals. A segment's shape is either
+ * a smooth cubic or an exponential approach. The curve is evaluated
+ * incrementally, with a few adds per interval.
+ *
+ * Profiles are saved in the EEPROM user data block, taking
+ * ORBITAL_MOUSE_EEPROM_SIZE bytes from ORBITAL_MOUSE_EEPROM_OFFSET. The offset
+ * is 0 by default, or with Adaptive Term enabled, just after its block at
+ * ADAPTIVE_TERM_EEPROM_SIZE. Set EECONFIG_USER_DATA_SIZE in config.h to at
+ * least ORBITAL_MOUSE_EEPROM_OFFSET + ORBITAL_MOUSE_EEPROM_SIZE. Define
+ * ORBITAL_MOUSE_PROFILES in config.h to change the default profiles.
+ */
+#ifndef ORBITAL_MOUSE_NUM_PROFILES
+#define ORBITAL_MOUSE_NUM_PROFILES 3
+#endif  // ORBITAL_MOUSE_NUM_PROFILES
+
+#ifndef ORBITAL_MOUSE_PROFILE_SEGMENTS
+#define ORBITAL_MOUSE_PROFILE_SEGMENTS 3
+#endif  // ORBITAL_MOUSE_PROFILE_SEGMENTS
+
+#ifndef ORBITAL_MOUSE_DEFAULT_PROFILE
+#define ORBITAL_MOUSE_DEFAULT_PROFILE 1
+#endif  // ORBITAL_MOUSE_DEFAULT_PROFILE
+
+#ifndef ORBITAL_MOUSE_EEPROM_OFFSET
+#ifdef ADAPTIVE_TERM_ENABLE
+#define ORBITAL_MOUSE_EEPROM_OFFSET ADAPTIVE_TERM_EEPROM_SIZE
+#else
+#define ORBITAL_MOUSE_EEPROM_OFFSET 0
+#endif  // ADAPTIVE_TERM_ENABLE
+#endif  // ORBITAL_MOUSE_EEPROM_OFFSET
+
+/** Bytes of the EEPROM user data block used to save the profiles. */
+#define ORBITAL_MOUSE_EEPROM_SIZE \
+  (3 + ORBITAL_MOUSE_NUM_PROFILES * (1 + 3 * ORBITAL_MOUSE_PROFILE_SEGMENTS))
+
+/** Shapes of acceleration profile segments. */
+enum {
+  /** Cubic ease in and out, reaching the target in exactly `frames`. */
+  ORBITAL_MOUSE_CUBIC = 0,
+  /** Exponential approach, fast at first, then snapping to the target. */
+  ORBITAL_MOUSE_EXP,
+};
+
+/** A segment of an acceleration profile. */
+typedef struct {
+  /** Segment shape, ORBITAL_MOUSE_CUBIC or ORBITAL_MOUSE_EXP. */
+  uint8_t shape;
+  /** Duration in intervals. Zero marks the end of the profile. */
+  uint8_t frames;
+  /** Speed at the segment's end, in pixels per interval, in Q6.2 format. */
+  uint8_t speed;
+} orbital_mouse_segment_t;
+
+/** An acceleration profile. */
+typedef struct {
+  /** Initial speed, in pixels per interval, in Q6.2 format. */
+  uint8_t speed;
+  orbital_mouse_segment_t segments[ORBITAL_MOUSE_PROFILE_SEGMENTS];
+} orbital_mouse_profile_t;
+
+/** Selects acceleration profile `profile`, and saves the choice to EEPROM. */
+void set_orbital_mouse_profile(uint8_t profile);
+
+/** Gets the index of the selected acceleration profile. */
+uint8_t get_orbital_mouse_profile(void);
+
+/**
+ * Replaces acceleration profile `i` and saves it to EEPROM.
+ *
+ * @param i        Index of the profile.
+ * @param profile  New profile. If NULL, the default from
+ *                 ORBITAL_MOUSE_PROFILES is restored.
+ */
+void set_orbital_mouse_profile_data(uint8_t i,
+                                    const orbital_mouse_profile_t* profile);
+
+/** Gets acceleration profile `i`, or NULL if out of range. */
+const orbital_mouse_profile_t* get_orbital_mouse_profile_data(uint8_t i);
+
+/**
+ * Gets the number of mouse reports sent in the last complete second of
+ * activity, for checking the achieved update rate.
+ *
+ * By default, Orbital Mouse updates every ORBITAL_MOUSE_INTERVAL_MS = 16 ms,
+ * about 62 reports per second. With `ORBITAL_MOUSE_VARIABLE_RATE` defined in
+ * config.h, it instead updates as often as every
+ * ORBITAL_MOUSE_MIN_INTERVAL_MS, which defaults to USB_POLLING_INTERVAL_MS,
+ * and integrates motion over the actual elapsed time. The speed curve keeps
+ * its meaning, while motion is smooth up to the host's polling rate.
+ */
+uint16_t get_orbital_mouse_report_rate(void);
+
 /**
  * Gets the heading direction as a value in 0-63.
  *
@@ -91,19 +197,24 @@ void set_orbital_mouse_speed_curve(const uint8_t* speed_curve);
  *      8 = up-left       40 = down-right
  *     16 = left          48 = right
  *     24 = down-left     56 = up-right
+ *
+ * Internally, the heading is finer than this. By default, movement follows 64
+ * distinct directions, 5.6 degrees apart. Define `ORBITAL_MOUSE_NUM_ANGLES` as
+ * 256 or 1024 in config.h for finer steering, with sines then interpolated
+ * from a quarter-wave table.
  */
 uint8_t get_orbital_mouse_angle(void);
 
 /** Sets the heading direction. */
 void set_orbital_mouse_angle(uint8_t angle);
 
-// The following defines the keycodes for Orbital Mouse. 29 keycodes are needed.
+// The following defines the keycodes for Orbital Mouse. 33 keycodes are needed.
 // While keycodes for userspace features are conventionally allocated in the
 // user-defined keycode range, that range is limited. It would be unreasonable
 // to allocate Orbital Mouse's keys there. Being a Mouse Keys replacement, we
 // repurpose the Mouse Keys keycodes (`MS_UP`, `MS_BTN1`, etc.) for the
 // analogous functions in Orbital Mouse. We also repurpose the block of keycodes
-// `UC(0x41)` to `UC(0x4a)`. These keycode represent Unicode input of ASCII
+// `UC(0x41)` to `UC(0x4e)`. These keycode represent Unicode input of ASCII
 // characters, which seems unlikely to be missed.
 enum {
   /** Move forward. */
@@ -165,6 +276,14 @@ enum {
   OM_SEL7 = ORBITAL_MOUSE_KEYCODE_RANGE_START + 8,
   /** Select mouse button 8. */
   OM_SEL8 = ORBITAL_MOUSE_KEYCODE_RANGE_START + 9,
-  ORBITAL_MOUSE_KEYCODE_RANGE_END = OM_SEL8,
+  /** Switch to the next acceleration profile. */
+  OM_PNXT = ORBITAL_MOUSE_KEYCODE_RANGE_START + 10,
+  /** Switch to acceleration profile 1, "precision" by default. */
+  OM_PRF1 = ORBITAL_MOUSE_KEYCODE_RANGE_START + 11,
+  /** Switch to acceleration profile 2, "normal" by default. */
+  OM_PRF2 = ORBITAL_MOUSE_KEYCODE_RANGE_START + 12,
+  /** Switch to acceleration profile 3, "flick" by default. */
+  OM_PRF3 = ORBITAL_MOUSE_KEYCODE_RANGE_START + 13,
+  ORBITAL_MOUSE_KEYCODE_RANGE_END = OM_PRF3,
 };
 
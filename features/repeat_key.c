@@ -46,6 +46,56 @@ static int8_t last_repeat_count = 0;
 // nonzero only while a repeated key is being processed.
 static int8_t processing_repeat_count = 0;
 
+// Ring buffer of the most recent keys, where `history[history_head]` is the
+// most recent and `history_count` is the number of valid entries.
+static uint16_t history[REPEAT_KEY_HISTORY_SIZE] = {0};
+static uint8_t history_head = 0;
+static uint8_t history_count = 0;
+// Number of the most recent entries pressed with no mods or only Shift, that
+// is, since the last hotkey. N-grams only match within these.
+static uint8_t history_text_count = 0;
+
+#if REPEAT_KEY_HISTORY_SIZE < 1 || REPEAT_KEY_HISTORY_SIZE > 255
+#error "repeat_key: REPEAT_KEY_HISTORY_SIZE must be between 1 and 255."
+#endif
+
+/** @brief Gets the keycode as typed, the tap keycode of tap-hold keys. */
+static uint16_t get_history_keycode(uint16_t keycode) {
+  switch (keycode) {
+#ifndef NO_ACTION_TAPPING
+    case QK_MOD_TAP ... QK_MOD_TAP_MAX:
+      return QK_MOD_TAP_GET_TAP_KEYCODE(keycode);
+#ifndef NO_ACTION_LAYER
+    case QK_LAYER_TAP ... QK_LAYER_TAP_MAX:
+      return QK_LAYER_TAP_GET_TAP_KEYCODE(keycode);
+#endif  // NO_ACTION_LAYER
+#endif  // NO_ACTION_TAPPING
+  }
+  return keycode;
+}
+
+/** @brief Gets the index of the history entry before entry `i`. */
+static uint8_t history_prev(uint8_t i) {
+  return (i ? i : REPEAT_KEY_HISTORY_SIZE) - 1;
+}
+
+static void push_history(uint16_t keycode) {
+  if (++history_head >= REPEAT_KEY_HISTORY_SIZE) {
+    history_head = 0;
+  }
+  history[history_head] = get_history_keycode(keycode);
+  if (history_count < REPEAT_KEY_HISTORY_SIZE) {
+    ++history_count;
+  }
+  // The key is performed with `last_mods`. With mods other than Shift, it is a
+  // hotkey rather than typed text, so it breaks the text for n-grams.
+  if ((last_mods & ~MOD_MASK_SHIFT) != 0) {
+    history_text_count = 0;
+  } else if (history_text_count < history_count) {
+    ++history_text_count;
+  }
+}
+
 /** @brief Updates `last_repeat_count` in direction `dir`. */
 static void update_last_repeat_count(int8_t dir) {
   if (dir * last_repeat_count < 0) {
@@ -59,6 +109,7 @@ static void set_last_record(uint16_t keycode, keyrecord_t* record) {
   last_record = *record;
   last_record.keycode = keycode;
   last_repeat_count = 0;
+  push_history(keycode);
 }
 
 static void repeat_key_invoke(const keyevent_t* event) {
@@ -81,6 +132,7 @@ static void repeat_key_invoke(const keyevent_t* event) {
     register_weak_mods(last_mods);
     registered_record = last_record;
     registered_repeat_count = last_repeat_count;
+    push_history(registered_record.keycode);
   }
 
   // Generate a keyrecord and plumb it into the event pipeline.
@@ -95,39 +147,157 @@ static void repeat_key_invoke(const keyevent_t* event) {
   }
 }
 
+// Default alternate keys, as X-macros of entries PAIR(a, b), mapping a to b
+// and b to a, or ALT(a, b), mapping only a to b. All keycodes must be basic.
+//
+// The following apply when the last key was pressed with a modifier other than
+// Shift. They map
+//   mod + F <-> mod + B
+// and a few others, supporting several core hotkeys used in Emacs, Vim, less,
+// and other programs.
+// clang-format off
+#define ALT_MOD_PAIRS(PAIR, ALT)                                  \
+    PAIR(KC_F   , KC_B   )  /* Forward / Backward. */             \
+    PAIR(KC_D   , KC_U   )  /* Down / Up. */                      \
+    PAIR(KC_N   , KC_P   )  /* Next / Previous. */                \
+    PAIR(KC_A   , KC_E   )  /* Home / End. */                     \
+    PAIR(KC_O   , KC_I   )  /* Vim jumplist Older / Newer. */
+
+// The following apply when the last key was pressed with no mods or only
+// Shift. They map a few more Vim hotkeys.
+#define ALT_PAIRS(PAIR, ALT)                                      \
+    PAIR(KC_J   , KC_K   )  /* Down / Up. */                      \
+    PAIR(KC_H   , KC_L   )  /* Left / Right. */                   \
+    /* These two lines map W and E to B, and B to W. */           \
+    PAIR(KC_W   , KC_B   )  /* Forward / Backward by word. */     \
+    ALT (KC_E   , KC_B   )  /* Forward / Backward by word. */
+
+// The following apply with any mods.
+#define ALT_ANY_PAIRS(PAIR, ALT)                                  \
+    PAIR(KC_LEFT, KC_RGHT)  /* Left / Right Arrow. */             \
+    PAIR(KC_UP  , KC_DOWN)  /* Up / Down Arrow. */                \
+    PAIR(KC_HOME, KC_END )  /* Home / End. */                     \
+    PAIR(KC_PGUP, KC_PGDN)  /* Page Up / Page Down. */            \
+    PAIR(KC_BSPC, KC_DEL )  /* Backspace / Delete. */             \
+    PAIR(KC_LBRC, KC_RBRC)  /* Brackets [ ] and { }. */           \
+    ALT_EXTRAKEY_PAIRS(PAIR, ALT)                                 \
+    ALT_MOUSEKEY_PAIRS(PAIR, ALT)
+
+#ifdef EXTRAKEY_ENABLE
+#define ALT_EXTRAKEY_PAIRS(PAIR, ALT)                             \
+    PAIR(KC_WBAK, KC_WFWD)  /* Browser Back / Forward. */         \
+    PAIR(KC_MNXT, KC_MPRV)  /* Next / Previous Media Track. */    \
+    PAIR(KC_MFFD, KC_MRWD)  /* Fast Forward / Rewind Media. */    \
+    PAIR(KC_VOLU, KC_VOLD)  /* Volume Up / Down. */               \
+    PAIR(KC_BRIU, KC_BRID)  /* Brightness Up / Down. */
+#else
+#define ALT_EXTRAKEY_PAIRS(PAIR, ALT)
+#endif  // EXTRAKEY_ENABLE
+
+#ifdef MOUSEKEY_ENABLE
+#define ALT_MOUSEKEY_PAIRS(PAIR, ALT)                             \
+    PAIR(KC_MS_L, KC_MS_R)  /* Mouse Cursor Left / Right. */      \
+    PAIR(KC_MS_U, KC_MS_D)  /* Mouse Cursor Up / Down. */         \
+    PAIR(KC_WH_L, KC_WH_R)  /* Mouse Wheel Left / Right. */       \
+    PAIR(KC_WH_U, KC_WH_D)  /* Mouse Wheel Up / Down. */
+#else
+#define ALT_MOUSEKEY_PAIRS(PAIR, ALT)
+#endif  // MOUSEKEY_ENABLE
+
+#define TABLE_PAIR(a, b) [a] = b, [b] = a,
+#define TABLE_ALT(a, b) [a] = b,
+// clang-format on
+
+// Tables of the alternate of each basic keycode, or KC_NO, without and with
+// Ctrl, Alt, or GUI mods. The tables are made at compile time from the lists
+// above with designated initializers. Later entries override earlier ones, so
+// the user's entries come last. Each table is only as long as its largest
+// listed keycode.
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Woverride-init"
+static const uint8_t alt_table[] PROGMEM = {
+    ALT_ANY_PAIRS(TABLE_PAIR, TABLE_ALT)
+    ALT_PAIRS(TABLE_PAIR, TABLE_ALT)
+    REPEAT_KEY_ALT_PAIRS_USER(TABLE_PAIR, TABLE_ALT)};
+static const uint8_t alt_mod_table[] PROGMEM = {
+    ALT_ANY_PAIRS(TABLE_PAIR, TABLE_ALT)
+    ALT_MOD_PAIRS(TABLE_PAIR, TABLE_ALT)
+    REPEAT_KEY_ALT_MOD_PAIRS_USER(TABLE_PAIR, TABLE_ALT)};
+#pragma GCC diagnostic pop
+
+#ifdef REPEAT_KEY_ALT_NGRAMS_USER
+typedef struct {
+  uint16_t alt_keycode;
+  uint8_t num_keys;
+  uint16_t keys[REPEAT_KEY_HISTORY_SIZE];  // Oldest first.
+} ngram_t;
+
+// An n-gram longer than REPEAT_KEY_HISTORY_SIZE is diagnosed at compile time
+// as "excess elements in array initializer."
+#define TABLE_NGRAM(alt, ...)                                   \
+  {(alt), sizeof((uint16_t[]){__VA_ARGS__}) / sizeof(uint16_t), \
+   {__VA_ARGS__}},
+
+static const ngram_t ngram_table[] PROGMEM = {
+    REPEAT_KEY_ALT_NGRAMS_USER(TABLE_NGRAM)};
+
+#define NUM_NGRAMS (sizeof(ngram_table) / sizeof(*ngram_table))
+
 /**
- * @brief Find alternate keycode from a table of opposing keycode pairs.
- * @param table Array of pairs of basic keycodes, declared as PROGMEM.
- * @param table_size_bytes The size of the table in bytes.
- * @param target The basic keycode to find.
- * @return The alternate basic keycode, or KC_NO if none was found.
- *
- * @note The table keycodes and target must be basic keycodes.
- *
- * This helper is used several times below to define alternate keys. Given a
- * table of pairs of basic keycodes, the function finds the pair containing
- * `target` and returns the other keycode in the pair.
+ * @brief Finds the alternate key of the longest n-gram ending the history.
+ * @return The alternate keycode, or KC_NO if no n-gram matches.
  */
-static uint8_t find_alt_keycode(const uint8_t (*table)[2],
-                                uint8_t table_size_bytes, uint8_t target) {
-  const uint8_t* keycodes = (const uint8_t*)table;
-  for (uint8_t i = 0; i < table_size_bytes; ++i) {
-    if (target == pgm_read_byte(keycodes + i)) {
-      // Xor (i ^ 1) the index to get the other element in the pair.
-      return pgm_read_byte(keycodes + (i ^ 1));
+static uint16_t find_ngram_alt_keycode(void) {
+  uint16_t alt_keycode = KC_NO;
+  uint8_t best_num_keys = 0;
+
+  for (uint16_t i = 0; i < NUM_NGRAMS; ++i) {
+    const ngram_t* ngram = &ngram_table[i];
+    const uint8_t num_keys = pgm_read_byte(&ngram->num_keys);
+    if (num_keys <= best_num_keys || num_keys > history_text_count) {
+      continue;
+    }
+    // Compare from the most recent key backwards.
+    uint8_t j = history_head;
+    uint8_t k = num_keys;
+    while (k && pgm_read_word(&ngram->keys[k - 1]) == history[j]) {
+      --k;
+      j = history_prev(j);
+    }
+    if (!k) {
+      best_num_keys = num_keys;
+      alt_keycode = pgm_read_word(&ngram->alt_keycode);
     }
   }
-  return KC_NO;
+
+  return alt_keycode;
 }
+#endif  // REPEAT_KEY_ALT_NGRAMS_USER
 
-static void alt_repeat_key_invoke(const keyevent_t* event) {
+/**
+ * @brief Find alternate keycode in a table made from keycode pairs.
+ * @param table Table indexed by basic keycode, declared as PROGMEM.
+ * @param table_size The size of the table in bytes.
+ * @param target The basic keycode to find.
+ * @return The alternate basic keycode, or KC_NO if none was found.
+ */
+static uint8_t find_alt_keycode(const uint8_t* table, uint16_t table_size,
+                                uint8_t target) {
+  return (target < table_size) ? pgm_read_byte(table + target) : KC_NO;
+}
+
+/**
+ * @brief Performs the alternate key.
+ * @return Whether an alternate key was performed.
+ */
+static bool alt_repeat_key_invoke(const keyevent_t* event) {
   static keyrecord_t registered_record = {0};
   static int8_t registered_repeat_count = 0;
   // Since this function calls process_record(), it may recursively call itself.
   // We return early if `processing_repeat_count` is nonzero to prevent infinite
   // recursion.
   if (processing_repeat_count) {
-    return;
+    return false;
   }
 
   if (event->pressed) {
@@ -142,12 +312,13 @@ static void alt_repeat_key_invoke(const keyevent_t* event) {
 
   // Early return if there is no alternate key defined.
   if (!registered_record.keycode) {
-    return;
+    return false;
   }
 
   if (event->pressed) {
     update_last_repeat_count(-1);
     registered_repeat_count = last_repeat_count;
+    push_history(registered_record.keycode);
   }
 
   // Generate a keyrecord and plumb it into the event pipeline.
@@ -155,6 +326,13 @@ static void alt_repeat_key_invoke(const keyevent_t* event) {
   processing_repeat_count = registered_repeat_count;
   process_record(&registered_record);
   processing_repeat_count = 0;
+
+  // The history changes on press, so the alternate key may differ by release.
+  // Forget the released key, so that it is released only once.
+  if (!event->pressed) {
+    registered_record.keycode = KC_NO;
+  }
+  return true;
 }
 
 __attribute__((weak)) bool get_repeat_key_eligible(uint16_t keycode,
@@ -225,8 +403,9 @@ bool process_repeat_key(uint16_t keycode, keyrecord_t* record,
 #endif  // NO_ACTION_ONESHOT
 
     if (remember_last_key_wrapper(keycode, record, &remembered_mods)) {
-      set_last_record(keycode, record);
+      // The mods are set first, so that the history records them.
       set_last_mods(remembered_mods);
+      set_last_record(keycode, record);
     }
   }
 
@@ -261,10 +440,32 @@ void set_last_keycode(uint16_t keycode) {
 
 void set_last_mods(uint8_t mods) { last_mods = mods; }
 
+uint8_t get_last_keycodes(uint16_t* keycodes, uint8_t n) {
+  if (n > history_count) {
+    n = history_count;
+  }
+  uint8_t j = history_head;
+  for (uint8_t i = 0; i < n; ++i) {
+    keycodes[i] = history[j];
+    j = history_prev(j);
+  }
+  return n;
+}
+
 uint16_t get_alt_repeat_key_keycode(void) {
   uint16_t keycode = last_record.keycode;
   uint8_t mods = last_mods;
 
+#ifdef REPEAT_KEY_ALT_NGRAMS_USER
+  // N-grams of the key history come first, being the most specific.
+  if ((mods & ~MOD_MASK_SHIFT) == 0) {
+    const uint16_t ngram_alt_keycode = find_ngram_alt_keycode();
+    if (ngram_alt_keycode) {
+      return ngram_alt_keycode;
+    }
+  }
+#endif  // REPEAT_KEY_ALT_NGRAMS_USER
+
   // Call the user callback first to give it a chance to override the default
   // alternate key definitions that follow.
   uint16_t alt_keycode = get_alt_repeat_key_keycode_user(keycode, mods);
@@ -307,64 +508,10 @@ uint16_t get_alt_repeat_key_keycode(void) {
   }
 
   if (IS_QK_BASIC(keycode)) {
-    if ((mods & (MOD_LCTL | MOD_LALT | MOD_LGUI))) {
-      // The last key was pressed with a modifier other than Shift. The
-      // following maps
-      //   mod + F <-> mod + B
-      // and a few others, supporting several core hotkeys used in Emacs, Vim,
-      // less, and other programs.
-      // clang-format off
-      static const uint8_t pairs[][2] PROGMEM = {
-          {KC_F   , KC_B   },  // Forward / Backward.
-          {KC_D   , KC_U   },  // Down / Up.
-          {KC_N   , KC_P   },  // Next / Previous.
-          {KC_A   , KC_E   },  // Home / End.
-          {KC_O   , KC_I   },  // Vim jumplist Older / Newer.
-      };
-      // clang-format on
-      alt_keycode = find_alt_keycode(pairs, sizeof(pairs), keycode);
-    } else {
-      // The last key was pressed with no mods or only Shift. The following map
-      // a few more Vim hotkeys.
-      // clang-format off
-      static const uint8_t pairs[][2] PROGMEM = {
-          {KC_J   , KC_K   },  // Down / Up.
-          {KC_H   , KC_L   },  // Left / Right.
-          // These two lines map W and E to B, and B to W.
-          {KC_W   , KC_B   },  // Forward / Backward by word.
-          {KC_E   , KC_B   },  // Forward / Backward by word.
-      };
-      // clang-format on
-      alt_keycode = find_alt_keycode(pairs, sizeof(pairs), keycode);
-    }
-
-    if (!alt_keycode) {
-      // The following key pairs are considered with any mods.
-      // clang-format off
-      static const uint8_t pairs[][2] PROGMEM = {
-          {KC_LEFT, KC_RGHT},  // Left / Right Arrow.
-          {KC_UP  , KC_DOWN},  // Up / Down Arrow.
-          {KC_HOME, KC_END },  // Home / End.
-          {KC_PGUP, KC_PGDN},  // Page Up / Page Down.
-          {KC_BSPC, KC_DEL },  // Backspace / Delete.
-          {KC_LBRC, KC_RBRC},  // Brackets [ ] and { }.
-#ifdef EXTRAKEY_ENABLE
-          {KC_WBAK, KC_WFWD},  // Browser Back / Forward.
-          {KC_MNXT, KC_MPRV},  // Next / Previous Media Track.
-          {KC_MFFD, KC_MRWD},  // Fast Forward / Rewind Media.
-          {KC_VOLU, KC_VOLD},  // Volume Up / Down.
-          {KC_BRIU, KC_BRID},  // Brightness Up / Down.
-#endif  // EXTRAKEY_ENABLE
-#ifdef MOUSEKEY_ENABLE
-          {KC_MS_L, KC_MS_R},  // Mouse Cursor Left / Right.
-          {KC_MS_U, KC_MS_D},  // Mouse Cursor Up / Down.
-          {KC_WH_L, KC_WH_R},  // Mouse Wheel Left / Right.
-          {KC_WH_U, KC_WH_D},  // Mouse Wheel Up / Down.
-#endif  // MOUSEKEY_ENABLE
-      };
-      // clang-format on
-      alt_keycode = find_alt_keycode(pairs, sizeof(pairs), keycode);
-    }
+    alt_keycode = (mods & (MOD_LCTL | MOD_LALT | MOD_LGUI))
+                      ? find_alt_keycode(alt_mod_table, sizeof(alt_mod_table),
+                                         keycode)
+                      : find_alt_keycode(alt_table, sizeof(alt_table), keycode);
 
     if (alt_keycode) {
       // Combine basic keycode with mods.
@@ -390,24 +537,15 @@ void repeat_key_tap(void) {
 }
 
 bool alt_repeat_key_register(void) {
-  if (get_alt_repeat_key_keycode()) {
-    alt_repeat_key_invoke(&MAKE_KEYEVENT(0, 0, true));
-    return true;
-  }
-  return false;
+  return alt_repeat_key_invoke(&MAKE_KEYEVENT(0, 0, true));
 }
 
 bool alt_repeat_key_unregister(void) {
-  if (get_alt_repeat_key_keycode()) {
-    alt_repeat_key_invoke(&MAKE_KEYEVENT(0, 0, false));
-    return true;
-  }
-  return false;
+  return alt_repeat_key_invoke(&MAKE_KEYEVENT(0, 0, false));
 }
 
 bool alt_repeat_key_tap(void) {
-  if (get_alt_repeat_key_keycode()) {
-    alt_repeat_key_register();
+  if (alt_repeat_key_register()) {
     wait_ms(TAP_CODE_DELAY);
     alt_repeat_key_unregister();
     return true;
@@ -47,6 +47,58 @@
 extern "C" {
 #endif
 
+/**
+ * Additional alternate keys for Alternate Repeat, defined in config.h as
+ * X-macros of entries `PAIR(a, b)`, mapping basic keycode a to b and b to a,
+ * or `ALT(a, b)`, mapping only a to b. `REPEAT_KEY_ALT_PAIRS_USER` applies when
+ * the last key was pressed with no mods or only Shift, and
+ * `REPEAT_KEY_ALT_MOD_PAIRS_USER` when pressed with Ctrl, Alt, or GUI. For
+ * example:
+ *
+ *     #define REPEAT_KEY_ALT_PAIRS_USER(PAIR, ALT) \
+ *       PAIR(KC_COMM, KC_DOT)                      \
+ *       ALT(KC_Y, KC_B)
+ *
+ * The entries are merged with the defaults, overriding them, into tables
+ * indexed by keycode at compile time, so that alternates are found in constant
+ * time. Mappings that aren't between basic keycodes or that depend on other
+ * state belong in `get_alt_repeat_key_keycode_user()`.
+ */
+#ifndef REPEAT_KEY_ALT_PAIRS_USER
+#define REPEAT_KEY_ALT_PAIRS_USER(PAIR, ALT)
+#endif  // REPEAT_KEY_ALT_PAIRS_USER
+
+#ifndef REPEAT_KEY_ALT_MOD_PAIRS_USER
+#define REPEAT_KEY_ALT_MOD_PAIRS_USER(PAIR, ALT)
+#endif  // REPEAT_KEY_ALT_MOD_PAIRS_USER
+
+/** Number of recent keys remembered, see `get_last_keycodes()`. */
+#ifndef REPEAT_KEY_HISTORY_SIZE
+#define REPEAT_KEY_HISTORY_SIZE 4
+#endif  // REPEAT_KEY_HISTORY_SIZE
+
+/**
+ * @def REPEAT_KEY_ALT_NGRAMS_USER
+ * Alternate keys depending on the last several keys, optionally defined in
+ * config.h as an X-macro of entries `NGRAM(alt_keycode, keys...)`, where
+ * `keys` are the last keys typed, oldest first. Tap-hold keys are given by
+ * their tap keycodes. For instance, for a magic key following "a", "qu", or
+ * "que" with different completions:
+ *
+ *     #define REPEAT_KEY_ALT_NGRAMS_USER(NGRAM) \
+ *       NGRAM(KC_O, KC_A)                      \
+ *       NGRAM(KC_E, KC_Q, KC_U)                \
+ *       NGRAM(M_NCE, KC_Q, KC_U, KC_E)
+ *
+ * When the last key was pressed with no mods or only Shift, the longest n-gram
+ * matching the end of the key history determines the alternate key. This takes
+ * precedence over `get_alt_repeat_key_keycode_user()` and the defaults. Every
+ * key of the n-gram must have been pressed with no mods or only Shift, so for
+ * instance, Ctrl+T followed by H doesn't match "th". N-grams may have up to
+ * `REPEAT_KEY_HISTORY_SIZE` keys. The n-grams are compiled into a PROGMEM
+ * table, searched in one pass.
+ */
+
 /**
  * Handler function for Repeat Key. Call either this function or
  * `process_repeat_key_with_rev()` (but not both) from `process_record_user()`
@@ -90,6 +142,18 @@ void set_last_keycode(uint16_t keycode);
 /** @brief Sets the last mods. */
 void set_last_mods(uint8_t mods);
 
+/**
+ * @brief Gets the most recent keys, most recent first.
+ *
+ * The history includes keys performed by Repeat and Alternate Repeat, so that
+ * it reflects what was typed. Tap-hold keys are recorded as their tap keycodes.
+ *
+ * @param keycodes Array to fill with up to `n` keycodes.
+ * @param n Maximum number of keycodes to get.
+ * @return Number of keycodes filled in, at most `REPEAT_KEY_HISTORY_SIZE`.
+ */
+uint8_t get_last_keycodes(uint16_t* keycodes, uint8_t n);
+
 /**
  * @brief Callback defining which keys are remembered.
  *
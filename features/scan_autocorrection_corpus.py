@@ -0,0 +1,377 @@
+# Copyright 2025 Google LLC
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     https://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""Scans a text corpus for autocorrection false triggers.
+
+This program types a plain-text corpus through a bit-exact re-implementation
+of process_autocorrection() in autocorrection.c, using the generated trie from
+autocorrection_data.h in any of the formats make_autocorrection_data.py makes.
+Run it like
+
+$ python3 scan_autocorrection_corpus.py corpus.txt
+
+or specify the generated header and a list of correctly spelled words:
+
+$ python3 scan_autocorrection_corpus.py --data somewhere/autocorrection_data.h \\
+    --words words.txt corpus.txt
+
+The corpus is memory mapped, so it may be gigabytes large. It is typed as on a
+US QWERTY layout: letters are keys a-z, optionally shifted, the apostrophe is
+KC_QUOT, and other printable ASCII characters, tabs, and newlines are word
+breaks. As on the keyboard, newline (Enter) also clears the typo buffer.
+Carriage returns are skipped, and any other byte, such as in non-ASCII UTF-8
+text, clears the typo buffer like a non-alpha key does.
+
+The program reports:
+
+ * How often autocorrection triggers, per megabyte of corpus.
+ * The cost of each keypress in trie steps, that is, PROGMEM reads made while
+   advancing the trie cursors, and the positions of the slowest keypresses.
+ * Every false correction. Without --words, the corpus is presumed to be
+   correctly spelled, so every trigger is false. With --words, a trigger is
+   false if the word in which it occurs is in the word list. Other triggers are
+   listed separately as presumed real typos.
+
+With --max-false-per-mb or --max-steps, the program exits with status 1 when
+the limit is exceeded, so that dictionary changes can be gated on the numbers.
+"""
+
+import argparse
+import heapq
+import mmap
+import os.path
+import re
+import sys
+import time
+from typing import Dict, List, Optional, Set, Tuple
+
+KC_A = 4
+KC_Z = 0x1d
+KC_ENT = 0x28
+KC_SPC = 0x2c
+KC_QUOT = 0x34
+
+# Byte classes of the corpus, besides keycodes.
+SKIP = -1
+CLEAR = -2
+
+DOUBLE_ARRAY_LEAF = 0x8000
+
+
+def make_byte_keys() -> List[int]:
+  """Maps each corpus byte to the keycode it types, or to SKIP or CLEAR."""
+  keys = [CLEAR] * 256
+  for c in range(0x20, 0x7f):
+    keys[c] = KC_SPC  # Printable ASCII symbols and digits are word breaks.
+  for c in range(26):
+    keys[ord('a') + c] = keys[ord('A') + c] = KC_A + c
+  keys[ord("'")] = KC_QUOT  # Shifted ", however, is a word break.
+  keys[ord('\t')] = KC_SPC
+  keys[ord('\n')] = KC_ENT
+  keys[ord('\r')] = SKIP
+  return keys
+
+
+class AutocorrectionData:
+  """Generated autocorrection data, with the trie decoders of the C code."""
+
+  def __init__(self, file_name: str):
+    with open(file_name, 'rt') as f:
+      code = f.read()
+
+    def define(name: str, default: Optional[int] = None) -> Optional[int]:
+      match = re.search(rf'^#define {name}\b *(\d*)', code, re.MULTILINE)
+      if not match:
+        return default
+      return int(match.group(1)) if match.group(1) else 1
+
+    def array(name: str) -> List[int]:
+      match = re.search(rf'\b{name}\[\d+\] PROGMEM = \{{([^}}]*)\}}', code)
+      if not match:
+        print(f'Error: {file_name} has no array "{name}".')
+        sys.exit(1)
+      return [int(v) for v in match.group(1).replace('\n', ' ').split(',')]
+
+    self.max_length = define('AUTOCORRECTION_MAX_LENGTH')
+    self.link_bytes = define('AUTOCORRECTION_LINK_BYTES', 2)
+    self.pool_bytes = define('AUTOCORRECTION_STRING_POOL_BYTES', 2)
+    self.double_array = bool(define('AUTOCORRECTION_DOUBLE_ARRAY'))
+    self.strings = (array('autocorrection_strings')
+                    if define('AUTOCORRECTION_STRING_POOL') else None)
+    if self.double_array:
+      self.base = array('autocorrection_base')
+      self.check = array('autocorrection_check')
+      self.leaves = array('autocorrection_leaves')
+    else:
+      self.data = array('autocorrection_data')
+
+  def trie_step(self, state: int, key: int) -> Tuple[int, int]:
+    """Mirrors trie_step(). Returns (next state or 0, PROGMEM reads)."""
+    if self.double_array:
+      base = self.base[state]
+      if base & DOUBLE_ARRAY_LEAF:
+        return 0, 1
+      symbol = (key - KC_A + 1 if KC_A <= key <= KC_Z
+                else 27 if key == KC_SPC else 28)
+      next_state = base + symbol
+      if next_state >= len(self.check) or self.check[next_state] != state:
+        return 0, 1 + (next_state < len(self.check))
+      return next_state, 2
+
+    data = self.data
+    reads = 1
+    code = data[state]
+    if code & 64:  # Check for match in node with multiple children.
+      code &= 63
+      while code != key:
+        if not code:
+          return 0, reads
+        state += 1 + self.link_bytes
+        code = data[state]
+        reads += 1
+      state = self.read_offset(data, state + 1, self.link_bytes)
+      reads += self.link_bytes
+    elif code != key:
+      return 0, reads
+    else:
+      state += 1
+      reads += 1
+      if not data[state]:
+        state += 1
+
+    if state >= len(data):
+      return 0, reads
+    return state, reads
+
+  def get_leaf(self, state: int) -> Tuple[Optional[int], int]:
+    """Mirrors get_leaf(). Returns (leaf offset or None, PROGMEM reads)."""
+    if self.double_array:
+      base = self.base[state]
+      return ((base & ~DOUBLE_ARRAY_LEAF) if base & DOUBLE_ARRAY_LEAF
+              else None), 1
+    return (state if self.data[state] & 128 else None), 1
+
+  def correction(self, leaf: int) -> Tuple[int, str]:
+    """Gets the backspaces and text typed for the leaf at `leaf`."""
+    data = self.leaves if self.double_array else self.data
+    backspaces = data[leaf] & 63
+    if self.strings is not None:
+      data = self.strings
+      start = self.read_offset(self.leaves if self.double_array else self.data,
+                               leaf + 1, self.pool_bytes)
+    else:
+      start = leaf + 1
+    end = data.index(0, start)
+    return backspaces, bytes(data[start:end]).decode('ascii')
+
+  @staticmethod
+  def read_offset(data: List[int], i: int, num_bytes: int) -> int:
+    return sum(data[i + k] << (8 * k) for k in range(num_bytes))
+
+
+class Typist:
+  """Mirrors the cursor state of process_autocorrection().
+
+  The set of live cursors is a function of the recent keys, and there are few
+  distinct sets in practice. So transitions are memoized, making the scan about
+  one dict lookup per key.
+  """
+
+  def __init__(self, data: AutocorrectionData):
+    self.data = data
+    self.transitions: Dict[Tuple[Tuple[int, ...], int],
+                           Tuple[Tuple[int, ...], Optional[int], int]] = {}
+
+  def advance(self, cursors: Tuple[int, ...],
+              key: int) -> Tuple[Tuple[int, ...], Optional[int], int]:
+    """Mirrors advance_cursors(). Returns (cursors, leaf or None, reads)."""
+    transition = self.transitions.get((cursors, key))
+    if transition is not None:
+      return transition
+
+    leaf = None
+    reads = 0
+    advanced = []
+    for cursor in cursors + (0,):
+      state, step_reads = self.data.trie_step(cursor, key)
+      reads += step_reads
+      if not state:
+        continue
+      state_leaf, leaf_reads = self.data.get_leaf(state)
+      reads += leaf_reads
+      if state_leaf is not None:
+        leaf = state_leaf
+      elif len(advanced) < self.data.max_length:
+        advanced.append(state)
+
+    transition = (tuple(advanced), leaf, reads)
+    self.transitions[(cursors, key)] = transition
+    return transition
+
+
+def get_word(corpus: mmap.mmap, pos: int) -> str:
+  """Gets the word around `pos`, of letters and apostrophes."""
+  is_word = lambda b: chr(b).isalpha() or b == ord("'")
+  start = pos
+  while start > 0 and pos - start < 64 and is_word(corpus[start - 1]):
+    start -= 1
+  end = pos
+  while end < len(corpus) and end - pos < 64 and is_word(corpus[end]):
+    end += 1
+  return corpus[start:end].decode('ascii', errors='replace').strip("'")
+
+
+def get_context(corpus: mmap.mmap, pos: int) -> str:
+  """Gets a snippet of the corpus leading up to `pos`."""
+  snippet = corpus[max(pos - 40, 0):pos + 1].decode('utf-8', errors='replace')
+  return snippet.replace('\n', ' ').replace('\r', ' ').replace('\t', ' ')
+
+
+def scan(corpus: mmap.mmap, data: AutocorrectionData,
+         num_slowest: int) -> Tuple[List[Tuple[int, int, str]],
+                                    List[Tuple[int, int]], Dict[int, int], int]:
+  """Types `corpus` through autocorrection.
+
+  Returns:
+    Tuple (triggers, slowest, histogram, num_keys), where triggers is a list of
+    (byte position, leaf offset) pairs, slowest the (reads, position) pairs of
+    the slowest keypresses, histogram maps reads to the number of keypresses
+    with that many reads, and num_keys is the number of keypresses.
+  """
+  byte_keys = make_byte_keys()
+  typist = Typist(data)
+  advance = typist.advance
+  triggers = []
+  slowest = []
+  histogram = {}
+  num_keys = 0
+  cursors = ()
+  chunk_size = 1 << 20
+
+  for chunk_start in range(0, len(corpus), chunk_size):
+    chunk = corpus[chunk_start:chunk_start + chunk_size]
+    for i, byte in enumerate(chunk):
+      key = byte_keys[byte]
+      if key < 0:
+        if key == CLEAR:
+          cursors = ()
+        continue
+      num_keys += 1
+      if key == KC_ENT:
+        cursors = ()
+        key = KC_SPC
+
+      cursors, leaf, reads = advance(cursors, key)
+      histogram[reads] = histogram.get(reads, 0) + 1
+      if len(slowest) < num_slowest:
+        heapq.heappush(slowest, (reads, chunk_start + i))
+      elif reads > slowest[0][0]:
+        heapq.heapreplace(slowest, (reads, chunk_start + i))
+
+      if leaf is not None:  # Autocorrection triggered.
+        triggers.append((chunk_start + i, leaf))
+        cursors = ()
+        if key == KC_SPC:
+          cursors, _, _ = advance(cursors, KC_SPC)
+
+  return triggers, sorted(slowest, reverse=True), histogram, num_keys
+
+
+def load_words(file_name: str) -> Set[str]:
+  with open(file_name, 'rt', errors='replace') as f:
+    return set(word.strip().lower() for word in f if word.strip())
+
+
+def get_default_data_file() -> str:
+  return os.path.join(os.path.dirname(os.path.abspath(__file__)),
+                      'autocorrection_data.h')
+
+
+def main(argv):
+  parser = argparse.ArgumentParser(
+      description='Scans a text corpus for autocorrection false triggers.')
+  parser.add_argument('corpus', help='plain-text corpus file')
+  parser.add_argument('--data', default=get_default_data_file(),
+                      help='generated autocorrection_data.h')
+  parser.add_argument('--words',
+                      help='list of correctly spelled words, one per line')
+  parser.add_argument('--slowest', type=int, default=10,
+                      help='number of slowest keypresses to list')
+  parser.add_argument('--max-false-per-mb', type=float,
+                      help='fail if false corrections per MB exceed this')
+  parser.add_argument('--max-steps', type=int,
+                      help='fail if a keypress takes more trie steps')
+  args = parser.parse_args(argv[1:])
+
+  data = AutocorrectionData(args.data)
+  words = load_words(args.words) if args.words else None
+
+  with open(args.corpus, 'rb') as f:
+    if os.fstat(f.fileno()).st_size == 0:
+      print('Error: The corpus is empty.')
+      sys.exit(1)
+    corpus = mmap.mmap(f.fileno(), 0, access=mmap.ACCESS_READ)
+    start_time = time.perf_counter()
+    triggers, slowest, histogram, num_keys = scan(corpus, data, args.slowest)
+    elapsed = time.perf_counter() - start_time
+
+    megabytes = len(corpus) / 1e6
+    false_corrections = []
+    real_corrections = []
+    for pos, leaf in triggers:
+      word = get_word(corpus, pos)
+      if words is None or word.lower() in words:
+        false_corrections.append((pos, leaf, word))
+      else:
+        real_corrections.append((pos, leaf, word))
+
+    total_reads = sum(reads * count for reads, count in histogram.items())
+    print(f'Scanned {megabytes:.2f} MB ({num_keys} keys) in {elapsed:.1f} s '
+          f'({megabytes / max(elapsed, 1e-9):.2f} MB/s).')
+    print(f'Triggers: {len(triggers)} ({len(triggers) / megabytes:.2f} per MB), '
+          f'false: {len(false_corrections)} '
+          f'({len(false_corrections) / megabytes:.2f} per MB)')
+    print(f'Trie steps per key: mean {total_reads / max(num_keys, 1):.2f}, '
+          f'max {max(histogram, default=0)}')
+
+    print('\nSlowest keypresses:')
+    for reads, pos in slowest:
+      print(f'  {reads:4d} steps at byte {pos}: "{get_context(corpus, pos)}"')
+
+    def print_corrections(title: str,
+                          corrections: List[Tuple[int, int, str]]) -> None:
+      print(f'\n{title} ({len(corrections)}):')
+      for pos, leaf, word in corrections:
+        backspaces, text = data.correction(leaf)
+        print(f'  byte {pos}, in "{word}": "{get_context(corpus, pos)}" '
+              f'-> {backspaces} backspaces, "{text}"')
+
+    print_corrections('False corrections', false_corrections)
+    if words is not None:
+      print_corrections('Presumed real typos', real_corrections)
+
+  failed = False
+  if (args.max_false_per_mb is not None and
+      len(false_corrections) / megabytes > args.max_false_per_mb):
+    print(f'\nFailed: More than {args.max_false_per_mb} false corrections '
+          'per MB.')
+    failed = True
+  if args.max_steps is not None and max(histogram, default=0) > args.max_steps:
+    print(f'\nFailed: A keypress took more than {args.max_steps} trie steps.')
+    failed = True
+  sys.exit(1 if failed else 0)
+
+
+if __name__ == '__main__':
+  main(sys.argv)
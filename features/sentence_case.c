@@ -24,6 +24,20 @@
 
 #include <string.h>
 
+#include "keycode_class.h"
+
+#ifdef SENTENCE_CASE_ABBREVIATIONS
+#include "sentence_case_abbreviations.h"
+
+#if SENTENCE_CASE_ABBREVIATIONS_MAX_LENGTH > SENTENCE_CASE_BUFFER_SIZE
+#error "sentence_case: SENTENCE_CASE_BUFFER_SIZE is too small for the longest abbreviation. Please increase it or shorten sentence_case_abbreviations.txt."
+#endif
+
+// Trie symbol for the start of a word. This must match WORD_START in
+// make_sentence_case_abbreviations.py.
+#define WORD_START 1
+#endif  // SENTENCE_CASE_ABBREVIATIONS
+
 #if !defined(IS_QK_MOD_TAP)
 // Attempt to detect out-of-date QMK installation, which would fail with
 // implicit-function-declaration errors in the code below.
@@ -35,8 +49,13 @@
 #error "sentence_case: Please enable oneshot."
 #else
 
-// Number of keys of state history to retain for backspacing.
-#define STATE_HISTORY_SIZE 6
+// Number of keys of history to retain for backspacing and for
+// `sentence_case_check_ending()`.
+#if SENTENCE_CASE_BUFFER_SIZE > 6
+#define HISTORY_SIZE SENTENCE_CASE_BUFFER_SIZE
+#else
+#define HISTORY_SIZE 6
+#endif  // SENTENCE_CASE_BUFFER_SIZE > 6
 
 // clang-format off
 /** States in matching the beginning of a sentence. */
@@ -48,15 +67,58 @@ enum {
   STATE_PRIMED,   /**< "Primed" state, in the space following an ending. */
   STATE_DISABLED, /**< Sentence Case is disabled. */
 };
+
+// Flags in the transition table, besides the next state.
+#define STATE_MASK   0x07
+#define CHECK_ENDING 0x08  // Go to INIT unless sentence_case_check_ending().
+#define CAPITALIZE   0x10  // Shift the key, unless retyping the last one shifted.
+#define UNSUPPRESS   0x20  // Allow capitalizing any key again.
+
+// Character classes, as returned by `sentence_case_press_user()`, and their
+// rows of the transition table, giving the next state from each state. This
+// matches things like "a. a" and "a.  a" but not "a.. a" or "a.a. a".
+//
+//  name    char  INIT          WORD                         ABBREV        ENDING                     PRIMED
+#define SENTENCE_CASE_CLASSES(X)                                                                                                 \
+  X(LETTER, 'a',  STATE_WORD,   STATE_WORD,                  STATE_ABBREV, STATE_ABBREV,              STATE_WORD | CAPITALIZE)   \
+  X(PERIOD, '.',  STATE_ABBREV, STATE_ENDING | CHECK_ENDING, STATE_ABBREV, STATE_ABBREV,              STATE_ABBREV)              \
+  X(SPACE,  ' ',  STATE_INIT,   STATE_INIT,                  STATE_INIT,   STATE_PRIMED | UNSUPPRESS, STATE_PRIMED | UNSUPPRESS) \
+  X(QUOTE,  '\'', STATE_INIT,   STATE_WORD,                  STATE_ABBREV, STATE_ENDING,              STATE_PRIMED)              \
+  X(SYMBOL, '#',  STATE_INIT,   STATE_INIT,                  STATE_INIT,   STATE_INIT,                STATE_INIT)                \
+  SENTENCE_CASE_USER_CLASSES(X)
+
+#define CLASS_ENUM(name, c, ...) CLASS_##name,
+#define CLASS_ROW(name, c, ...) {__VA_ARGS__},
+#define CLASS_CASE(name, c, ...) case c: return CLASS_##name;
 // clang-format on
 
+enum { SENTENCE_CASE_CLASSES(CLASS_ENUM) NUM_CLASSES };
+
+static const uint8_t transitions[NUM_CLASSES][STATE_DISABLED] PROGMEM = {
+    SENTENCE_CASE_CLASSES(CLASS_ROW)};
+
+// Gets the class of char code `c`. Unknown codes are symbols.
+static uint8_t get_class(char c) {
+  switch (c) {
+    SENTENCE_CASE_CLASSES(CLASS_CASE)
+  }
+  return CLASS_SYMBOL;
+}
+
 #if SENTENCE_CASE_TIMEOUT > 0
 static uint16_t idle_timer = 0;
 #endif  // SENTENCE_CASE_TIMEOUT > 0
+// History of the last HISTORY_SIZE keys, as ring buffers sharing the head
+// index `history_head`, which points to the oldest key. `state_history` holds
+// the state before each key. The keycodes in `key_buffer` are stored twice, at
+// i and i + HISTORY_SIZE, so that the last keys are always contiguous in
+// memory, as `sentence_case_check_ending()` expects. This way, adding or
+// removing a key takes constant time regardless of the buffer size.
+static uint8_t history_head = 0;
+static uint8_t state_history[HISTORY_SIZE];
 #if SENTENCE_CASE_BUFFER_SIZE > 1
-static uint16_t key_buffer[SENTENCE_CASE_BUFFER_SIZE] = {0};
+static uint16_t key_buffer[2 * HISTORY_SIZE] = {0};
 #endif  // SENTENCE_CASE_BUFFER_SIZE > 1
-static uint8_t state_history[STATE_HISTORY_SIZE];
 static uint16_t suppress_key = KC_NO;
 static uint8_t sentence_state = STATE_INIT;
 
@@ -78,6 +140,37 @@ static void set_sentence_state(uint8_t new_state) {
   sentence_state = new_state;
 }
 
+// Appends a key to the history, along with the state before it.
+static void push_history(uint16_t keycode, uint8_t state) {
+  state_history[history_head] = state;
+#if SENTENCE_CASE_BUFFER_SIZE > 1
+  key_buffer[history_head] = key_buffer[history_head + HISTORY_SIZE] = keycode;
+#endif  // SENTENCE_CASE_BUFFER_SIZE > 1
+  if (++history_head >= HISTORY_SIZE) {
+    history_head = 0;
+  }
+}
+
+// Removes the last key from the history and returns the state before it. The
+// oldest key becomes KC_NO with state STATE_INIT.
+static uint8_t pop_history(void) {
+  history_head = (history_head ? history_head : HISTORY_SIZE) - 1;
+  const uint8_t state = state_history[history_head];
+  state_history[history_head] = STATE_INIT;
+#if SENTENCE_CASE_BUFFER_SIZE > 1
+  key_buffer[history_head] = key_buffer[history_head + HISTORY_SIZE] = KC_NO;
+#endif  // SENTENCE_CASE_BUFFER_SIZE > 1
+  return state;
+}
+
+const uint16_t* sentence_case_get_buffer(void) {
+#if SENTENCE_CASE_BUFFER_SIZE > 1
+  return key_buffer + history_head + (HISTORY_SIZE - SENTENCE_CASE_BUFFER_SIZE);
+#else
+  return NULL;
+#endif  // SENTENCE_CASE_BUFFER_SIZE > 1
+}
+
 static void clear_state_history(void) {
 #if SENTENCE_CASE_TIMEOUT > 0
   idle_timer = 0;
@@ -188,113 +281,49 @@ bool process_sentence_case(uint16_t keycode, keyrecord_t* record) {
 
   if (keycode == KC_BSPC) {
     // Backspace key pressed. Rewind the state and key buffers.
-    set_sentence_state(state_history[STATE_HISTORY_SIZE - 1]);
-
-    memmove(state_history + 1, state_history, STATE_HISTORY_SIZE - 1);
-    state_history[0] = STATE_INIT;
-#if SENTENCE_CASE_BUFFER_SIZE > 1
-    memmove(key_buffer + 1, key_buffer,
-            (SENTENCE_CASE_BUFFER_SIZE - 1) * sizeof(uint16_t));
-    key_buffer[0] = KC_NO;
-#endif  // SENTENCE_CASE_BUFFER_SIZE > 1
+    set_sentence_state(pop_history());
     return true;
   }
 
   const uint8_t mods = get_mods() | get_weak_mods() | get_oneshot_mods();
-  uint8_t new_state = STATE_INIT;
-
-  // We search for sentence beginnings using a simple finite state machine. It
-  // matches things like "a. a" and "a.  a" but not "a.. a" or "a.a. a". The
-  // state transition matrix is:
-  //
-  //             'a'       '.'      ' '      '\''
-  //           +-------------------------------------
-  //   INIT    | WORD      INIT     INIT     INIT
-  //   WORD    | WORD      ENDING   INIT     WORD
-  //   ABBREV  | ABBREV    ABBREV   INIT     ABBREV
-  //   ENDING  | ABBREV    INIT     PRIMED   ENDING
-  //   PRIMED  | match!    INIT     PRIMED   PRIMED
-  char code = sentence_case_press_user(keycode, record, mods);
+  const char code = sentence_case_press_user(keycode, record, mods);
 #if defined SENTENCE_CASE_DEBUG
   dprintf("Sentence Case: code = '%c' (%d)\n", code, (int)code);
 #endif  // SENTENCE_CASE_DEBUG
-  switch (code) {
-    case '\0':  // Current key should be ignored.
-      return true;
-
-    case 'a':  // Current key is a letter.
-      switch (sentence_state) {
-        case STATE_ABBREV:
-        case STATE_ENDING:
-          new_state = STATE_ABBREV;
-          break;
-
-        case STATE_PRIMED:
-          // This is the start of a sentence.
-          if (keycode != suppress_key) {
-            suppress_key = keycode;
-            set_oneshot_mods(MOD_BIT(KC_LSFT));  // Shift mod to capitalize.
-            new_state = STATE_WORD;
-          }
-          break;
-
-        default:
-          new_state = STATE_WORD;
-      }
-      break;
-
-    case '.':  // Current key is sentence-ending punctuation.
-      switch (sentence_state) {
-        case STATE_WORD:
-          new_state = STATE_ENDING;
-          break;
-
-        default:
-          new_state = STATE_ABBREV;
-      }
-      break;
-
-    case ' ':  // Current key is a space.
-      if (sentence_state == STATE_PRIMED ||
-          (sentence_state == STATE_ENDING
-#if SENTENCE_CASE_BUFFER_SIZE > 1
-           && sentence_case_check_ending(key_buffer)
-#endif  // SENTENCE_CASE_BUFFER_SIZE > 1
-               )) {
-        new_state = STATE_PRIMED;
-        suppress_key = KC_NO;
-      }
-      break;
-
-    case '\'':  // Current key is a quote.
-      new_state = sentence_state;
-      break;
+  if (code == '\0') {  // Current key should be ignored.
+    return true;
   }
 
-    // Slide key_buffer and state_history buffers one element to the left.
-    // Optimization note: Using manual loops instead of memmove() here saved
-    // ~100 bytes on AVR.
-#if SENTENCE_CASE_BUFFER_SIZE > 1
-  for (int8_t i = 0; i < SENTENCE_CASE_BUFFER_SIZE - 1; ++i) {
-    key_buffer[i] = key_buffer[i + 1];
+  // Step the state machine. It searches for sentence beginnings.
+  uint8_t new_state =
+      pgm_read_byte(&transitions[get_class(code)][sentence_state]);
+
+  if (new_state & UNSUPPRESS) {
+    suppress_key = KC_NO;
   }
-#endif  // SENTENCE_CASE_BUFFER_SIZE > 1
-  for (int8_t i = 0; i < STATE_HISTORY_SIZE - 1; ++i) {
-    state_history[i] = state_history[i + 1];
+  if (new_state & CAPITALIZE) {
+    // This is the start of a sentence.
+    if (keycode != suppress_key) {
+      suppress_key = keycode;
+      set_oneshot_mods(MOD_BIT(KC_LSFT));  // Shift mod to capitalize.
+    } else {
+      new_state = STATE_INIT;
+    }
   }
 
+  push_history(keycode, sentence_state);
+
 #if SENTENCE_CASE_BUFFER_SIZE > 1
-  key_buffer[SENTENCE_CASE_BUFFER_SIZE - 1] = keycode;
-  if (new_state == STATE_ENDING && !sentence_case_check_ending(key_buffer)) {
+  if ((new_state & CHECK_ENDING) &&
+      !sentence_case_check_ending(sentence_case_get_buffer())) {
 #if defined SENTENCE_CASE_DEBUG
     dprintf("Not a real ending.\n");
 #endif  // SENTENCE_CASE_DEBUG
     new_state = STATE_INIT;
   }
 #endif  // SENTENCE_CASE_BUFFER_SIZE > 1
-  state_history[STATE_HISTORY_SIZE - 1] = sentence_state;
 
-  set_sentence_state(new_state);
+  set_sentence_state(new_state & STATE_MASK);
   return true;
 }
 
@@ -313,14 +342,66 @@ bool sentence_case_just_typed_P(const uint16_t* buffer, const uint16_t* pattern,
 #endif  // SENTENCE_CASE_BUFFER_SIZE > 1
 }
 
+#ifdef SENTENCE_CASE_ABBREVIATIONS
+bool sentence_case_just_typed_abbreviation(const uint16_t* buffer) {
+  // The trie is of the abbreviations written backwards, so walk backwards from
+  // the last key. The trie encoding is as in autocorrection_data.h, except that
+  // there are no leaves: matching WORD_START completes a match.
+  uint16_t state = 0;
+  for (int8_t i = SENTENCE_CASE_BUFFER_SIZE - 1; i >= 0; --i) {
+    uint8_t symbol;
+    switch (buffer[i]) {
+      case KC_A ... KC_Z:
+      case KC_QUOT:
+      case KC_DOT:
+        symbol = buffer[i];
+        break;
+      default:
+        symbol = WORD_START;
+    }
+
+    uint8_t code = pgm_read_byte(sentence_case_abbreviations_data + state);
+    if (code & 64) {  // Check for match in node with multiple children.
+      code &= 63;
+      for (; code != symbol;
+           code = pgm_read_byte(sentence_case_abbreviations_data +
+                                (state += 3))) {
+        if (!code) {
+          return false;
+        }
+      }
+      if (symbol == WORD_START) {
+        return true;
+      }
+      // Follow link to child node.
+      state = pgm_read_byte(sentence_case_abbreviations_data + state + 1) |
+              pgm_read_byte(sentence_case_abbreviations_data + state + 2) << 8;
+      // Otherwise check for match in node with a single child.
+    } else if (code != symbol) {
+      return false;
+    } else if (symbol == WORD_START) {
+      return true;
+    } else if (!pgm_read_byte(sentence_case_abbreviations_data + (++state))) {
+      ++state;  // End of the chain, step over the terminator.
+    }
+  }
+  return false;  // Ran out of buffer before the start of the word.
+}
+#endif  // SENTENCE_CASE_ABBREVIATIONS
+
 __attribute__((weak)) bool sentence_case_check_ending(const uint16_t* buffer) {
-#if SENTENCE_CASE_BUFFER_SIZE >= 5
+#ifdef SENTENCE_CASE_ABBREVIATIONS
+  // Don't consider listed abbreviations like "vs." to end the sentence.
+  if (sentence_case_just_typed_abbreviation(buffer)) {
+    return false;  // Not a real sentence ending.
+  }
+#elif SENTENCE_CASE_BUFFER_SIZE >= 5
   // Don't consider the abbreviations "vs." and "etc." to end the sentence.
   if (SENTENCE_CASE_JUST_TYPED(KC_SPC, KC_V, KC_S, KC_DOT) ||
       SENTENCE_CASE_JUST_TYPED(KC_SPC, KC_E, KC_T, KC_C, KC_DOT)) {
     return false;  // Not a real sentence ending.
   }
-#endif  // SENTENCE_CASE_BUFFER_SIZE >= 5
+#endif  // SENTENCE_CASE_ABBREVIATIONS
   return true;  // Real sentence ending; capitalize next letter.
 }
 
@@ -328,32 +409,18 @@ __attribute__((weak)) char sentence_case_press_user(uint16_t keycode,
                                                     keyrecord_t* record,
                                                     uint8_t mods) {
   if ((mods & ~(MOD_MASK_SHIFT | MOD_BIT(KC_RALT))) == 0) {
-    const bool shifted = mods & MOD_MASK_SHIFT;
-    switch (keycode) {
-      case KC_A ... KC_Z:
-        return 'a';  // Letter key.
-
-      case KC_DOT:  // . is punctuation, Shift . is a symbol (>)
-        return !shifted ? '.' : '#';
-      case KC_1:
-      case KC_SLSH:
-        return shifted ? '.' : '#';
-      case KC_EXLM:
-      case KC_QUES:
-        return '.';
-      case KC_2 ... KC_0:  // 2 3 4 5 6 7 8 9 0
-      case KC_AT ... KC_RPRN:  // @ # $ % ^ & * ( )
-      case KC_MINS ... KC_SCLN:  // - = [ ] backslash ;
-      case KC_UNDS ... KC_COLN:  // _ + { } | :
-      case KC_GRV:
-      case KC_COMM:
-        return '#';  // Symbol key.
-
-      case KC_SPC:
-        return ' ';  // Space key.
-
-      case KC_QUOT:
-        return '\'';  // Quote key.
+    const uint8_t flags =
+        get_typed_keycode_class(keycode, mods & MOD_MASK_SHIFT);
+    if (flags & KEYCODE_CLASS_ALPHA) {
+      return 'a';  // Letter key.
+    } else if (flags & KEYCODE_CLASS_ENDING) {
+      return '.';  // . ? !
+    } else if (flags & KEYCODE_CLASS_SYMBOL) {
+      return '#';  // Symbol key.
+    } else if (flags & KEYCODE_CLASS_SPACE) {
+      return ' ';  // Space key.
+    } else if (flags & KEYCODE_CLASS_QUOTE) {
+      return '\'';  // Quote key.
     }
   }
 
@@ -37,6 +37,12 @@
  * detected as not real sentence endings. You can use the callback
  * `sentence_case_check_ending()` to define other exceptions.
  *
+ * For a longer list of abbreviations, run make_sentence_case_abbreviations.py
+ * to compile sentence_case_abbreviations.txt into a trie in
+ * sentence_case_abbreviations.h, and define `SENTENCE_CASE_ABBREVIATIONS` in
+ * config.h. Then the default `sentence_case_check_ending()` checks all listed
+ * abbreviations instead, in a single backwards walk over the key buffer.
+ *
  * @note One-shot keys must be enabled.
  *
  * For full documentation, see
@@ -58,6 +64,25 @@ extern "C" {
 #define SENTENCE_CASE_BUFFER_SIZE 8
 #endif  // SENTENCE_CASE_BUFFER_SIZE
 
+/*
+ * Additional character classes for `sentence_case_press_user()`, as an X-macro
+ * of rows of the state transition table in sentence_case.c. Each row is
+ * `X(name, char, init, word, abbrev, ending, primed)`, giving the next state
+ * from each state. States are STATE_INIT, STATE_WORD, STATE_ABBREV,
+ * STATE_ENDING, and STATE_PRIMED, optionally combined with the flags
+ * CHECK_ENDING, CAPITALIZE, or UNSUPPRESS. For instance, to have closing
+ * parentheses act like quotes, define in config.h
+ *
+ *   #define SENTENCE_CASE_USER_CLASSES(X)                              \
+ *     X(CLOSE, ')', STATE_INIT, STATE_WORD, STATE_ABBREV, STATE_ENDING, \
+ *       STATE_PRIMED)
+ *
+ * and return ')' from `sentence_case_press_user()` for KC_RPRN.
+ */
+#ifndef SENTENCE_CASE_USER_CLASSES
+#define SENTENCE_CASE_USER_CLASSES(X)
+#endif  // SENTENCE_CASE_USER_CLASSES
+
 /**
  * Handler function for Sentence Case.
  *
@@ -145,6 +170,30 @@ bool sentence_case_check_ending(const uint16_t* buffer);
 bool sentence_case_just_typed_P(const uint16_t* buffer, const uint16_t* pattern,
                                 int8_t pattern_len);
 
+#ifdef SENTENCE_CASE_ABBREVIATIONS
+/**
+ * Checks whether the buffer ends in one of the compiled abbreviations.
+ *
+ * The abbreviations are those of sentence_case_abbreviations.h, as made by
+ * make_sentence_case_abbreviations.py. An abbreviation matches only at the
+ * start of a word, for instance "dr." matches " dr." but not " hdr.". This may
+ * be called from `sentence_case_check_ending()`.
+ *
+ * @param buffer Buffer of the last `SENTENCE_CASE_BUFFER_SIZE` keycodes.
+ * @return whether an abbreviation was just typed.
+ */
+bool sentence_case_just_typed_abbreviation(const uint16_t* buffer);
+#endif  // SENTENCE_CASE_ABBREVIATIONS
+
+/**
+ * Gets the buffer of the last `SENTENCE_CASE_BUFFER_SIZE` keycodes, oldest
+ * first, as passed to `sentence_case_check_ending()`.
+ *
+ * The buffer is a view into Sentence Case's key history and is valid only
+ * until the next key event. Returns NULL if `SENTENCE_CASE_BUFFER_SIZE < 2`.
+ */
+const uint16_t* sentence_case_get_buffer(void);
+
 /**
  * Optional callback defining which keys are letter, punctuation, etc.
  *
@@ -166,42 +215,32 @@ bool sentence_case_just_typed_P(const uint16_t* buffer, const uint16_t* pattern,
  *
  *  '\0'  Sentence Case should ignore this key.
  *
+ * Other chars are handled as symbols like '#', unless defined as character
+ * classes in `SENTENCE_CASE_USER_CLASSES`.
+ *
  * If a hotkey or navigation key is pressed (or another key that performs an
  * action that backspace doesn't undo), then the callback should call
  * `sentence_case_clear()` to clear the state and then return '\0'.
  *
- * The default callback is:
+ * The default callback classifies keys with the shared table of
+ * keycode_class.h:
  *
  *     char sentence_case_press_user(uint16_t keycode,
  *                                   keyrecord_t* record,
  *                                   uint8_t mods) {
  *       if ((mods & ~(MOD_MASK_SHIFT | MOD_BIT(KC_RALT))) == 0) {
- *         const bool shifted = mods & MOD_MASK_SHIFT;
- *         switch (keycode) {
- *           case KC_A ... KC_Z:
- *             return 'a';  // Letter key.
- *
- *           case KC_DOT:  // . is punctuation, Shift . is a symbol (>)
- *             return !shifted ? '.' : '#';
- *           case KC_1:
- *           case KC_SLSH:
- *             return shifted ? '.' : '#';
- *           case KC_EXLM:
- *           case KC_QUES:
- *             return '.';
- *           case KC_2 ... KC_0:  // 2 3 4 5 6 7 8 9 0
- *           case KC_AT ... KC_RPRN:  // @ # $ % ^ & * ( )
- *           case KC_MINS ... KC_SCLN:  // - = [ ] backslash ;
- *           case KC_UNDS ... KC_COLN:  // _ + { } | :
- *           case KC_GRV:
- *           case KC_COMM:
- *             return '#';  // Symbol key.
- *
- *           case KC_SPC:
- *             return ' ';  // Space key.
- *
- *           case KC_QUOT:
- *             return '\'';  // Quote key.
+ *         const uint8_t flags =
+ *             get_typed_keycode_class(keycode, mods & MOD_MASK_SHIFT);
+ *         if (flags & KEYCODE_CLASS_ALPHA) {
+ *           return 'a';  // Letter key.
+ *         } else if (flags & KEYCODE_CLASS_ENDING) {
+ *           return '.';  // . ? !
+ *         } else if (flags & KEYCODE_CLASS_SYMBOL) {
+ *           return '#';  // Symbol key.
+ *         } else if (flags & KEYCODE_CLASS_SPACE) {
+ *           return ' ';  // Space key.
+ *         } else if (flags & KEYCODE_CLASS_QUOTE) {
+ *           return '\'';  // Quote key.
  *         }
  *       }
  *
@@ -210,8 +249,8 @@ bool sentence_case_just_typed_P(const uint16_t* buffer, const uint16_t* pattern,
  *       return '\0';
  *     }
  *
- * To customize, copy the above function into your keymap and add/remove
- * keycodes to the above cases.
+ * To customize, copy the above function into your keymap and handle other
+ * keycodes with a switch before the table lookup.
  *
  * @param keycode Current keycode.
  * @param record record_t for the current press event.
@@ -0,0 +1,42 @@
+// Generated code.
+
+// Sentence Case abbreviations (85 entries):
+//   abbr. adj. adm. adv. al. approx. apr. assn. asst. atty. aug. ave. bldg.
+//   blvd. brig. bros. capt. cf. ch. cmdr. co. col. corp. cpl. dec. dept. dist.
+//   dr. eds. esp. est. etc. feb. fig. figs. ft. gen. gov. hon. hr. hrs. inc.
+//   incl. jan. jr. jul. jun. lb. lbs. lt. ltd. maj. mar. misc. mr. mrs. ms. mt.
+//   mtn. nos. nov. oct. pp. pres. prof. pt. rd. ref. rep. rev. sec. sen. sep.
+//   sept. sgt. sr. st. supt. tel. univ. vol. vols. vs. yr. yrs.
+
+// Keys to match, including the key before the abbreviation.
+#define SENTENCE_CASE_ABBREVIATIONS_MAX_LENGTH 8  // " approx."
+
+static const uint8_t sentence_case_abbreviations_data[591] PROGMEM = {55, 0, 69,
+  60, 0, 6, 72, 0, 7, 106, 0, 8, 125, 0, 9, 129, 0, 10, 148, 0, 11, 177, 0, 13,
+  180, 0, 15, 193, 0, 16, 238, 0, 17, 242, 0, 18, 32, 1, 19, 35, 1, 21, 68, 1,
+  22, 126, 1, 23, 204, 1, 25, 33, 2, 27, 67, 2, 28, 74, 2, 0, 72, 67, 0, 15, 70,
+  0, 0, 9, 1, 0, 1, 0, 72, 85, 0, 17, 96, 0, 22, 99, 0, 23, 103, 0, 0, 71, 92,
+  0, 22, 94, 0, 0, 1, 0, 1, 0, 12, 1, 0, 12, 16, 1, 0, 8, 1, 0, 85, 116, 0, 23,
+  118, 0, 25, 121, 0, 0, 1, 0, 15, 1, 0, 15, 5, 1, 0, 25, 4, 1, 0, 70, 139, 0,
+  8, 141, 0, 18, 144, 0, 0, 1, 0, 21, 1, 0, 21, 19, 1, 0, 71, 158, 0, 12, 162,
+  0, 24, 174, 0, 0, 15, 5, 1, 0, 73, 169, 0, 21, 171, 0, 0, 1, 0, 5, 1, 0, 4, 1,
+  0, 6, 1, 0, 68, 187, 0, 7, 190, 0, 0, 16, 1, 0, 4, 1, 0, 68, 212, 0, 6, 214,
+  0, 8, 218, 0, 18, 221, 0, 19, 232, 0, 24, 235, 0, 0, 1, 0, 17, 12, 1, 0, 23,
+  1, 0, 70, 228, 0, 25, 230, 0, 0, 1, 0, 1, 0, 6, 1, 0, 13, 1, 0, 7, 4, 1, 0,
+  68, 5, 1, 8, 8, 1, 18, 19, 1, 22, 22, 1, 23, 26, 1, 24, 29, 1, 0, 13, 1, 0,
+  74, 15, 1, 22, 17, 1, 0, 1, 0, 1, 0, 11, 1, 0, 22, 4, 1, 0, 16, 1, 0, 13, 1,
+  0, 6, 1, 0, 72, 48, 1, 19, 59, 1, 21, 61, 1, 22, 65, 1, 0, 85, 55, 1, 22, 57,
+  1, 0, 1, 0, 1, 0, 1, 0, 18, 6, 1, 0, 8, 1, 0, 68, 96, 1, 5, 99, 1, 7, 103, 1,
+  11, 113, 1, 13, 115, 1, 16, 117, 1, 19, 119, 1, 22, 122, 1, 28, 124, 1, 0, 16,
+  1, 0, 5, 4, 1, 0, 65, 0, 0, 16, 110, 1, 0, 6, 1, 0, 1, 0, 1, 0, 1, 0, 4, 1, 0,
+  1, 0, 1, 0, 69, 154, 1, 7, 157, 1, 8, 160, 1, 10, 164, 1, 15, 168, 1, 16, 172,
+  1, 18, 174, 1, 21, 186, 1, 25, 202, 1, 0, 15, 1, 0, 8, 1, 0, 21, 19, 1, 0, 12,
+  9, 1, 0, 18, 25, 1, 0, 1, 0, 81, 181, 1, 21, 183, 1, 0, 1, 0, 5, 1, 0, 75,
+  196, 1, 16, 198, 1, 28, 200, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 70, 226, 1, 9, 229,
+  1, 10, 231, 1, 15, 234, 1, 16, 236, 1, 19, 238, 1, 22, 12, 2, 0, 18, 1, 0, 1,
+  0, 22, 1, 0, 1, 0, 1, 0, 65, 0, 0, 4, 251, 1, 8, 254, 1, 24, 9, 2, 0, 6, 1, 0,
+  71, 5, 2, 22, 7, 2, 0, 1, 0, 1, 0, 22, 1, 0, 65, 0, 0, 8, 25, 2, 12, 27, 2,
+  22, 30, 2, 0, 1, 0, 7, 1, 0, 4, 1, 0, 71, 46, 2, 8, 49, 2, 12, 52, 2, 18, 56,
+  2, 0, 4, 1, 0, 21, 1, 0, 17, 24, 1, 0, 74, 63, 2, 17, 65, 2, 0, 1, 0, 1, 0,
+  18, 21, 19, 19, 4, 1, 0, 23, 23, 4, 1, 0};
+
@@ -25,6 +25,9 @@
  * <https://getreuer.info/posts/keyboards>
  */
 
+#include "features/event_trace.h"
+#include "features/keycode_class.h"
+
 enum layers {
   BASE,
   SYM,
@@ -437,14 +440,18 @@ bool apply_autocorrect(uint8_t backspaces, const char* str,
 ///////////////////////////////////////////////////////////////////////////////
 #ifdef CAPS_WORD_ENABLE
 bool caps_word_press_user(uint16_t keycode) {
-  switch (keycode) {
-    // Keycodes that continue Caps Word, with shift applied.
-    case KC_A ... KC_Z:
-      add_weak_mods(MOD_BIT_LSHIFT);  // Apply shift to the next key.
-      return true;
+  const uint8_t flags = get_keycode_class(keycode);
+  // Keycodes that continue Caps Word, with shift applied.
+  if (flags & KEYCODE_CLASS_ALPHA) {
+    add_weak_mods(MOD_BIT_LSHIFT);  // Apply shift to the next key.
+    return true;
+  }
 
-    // Keycodes that continue Caps Word, without shifting.
-    case KC_1 ... KC_0:
+  // Keycodes that continue Caps Word, without shifting.
+  if (flags & KEYCODE_CLASS_DIGIT) {
+    return true;
+  }
+  switch (keycode) {
     case KC_BSPC:
     case KC_DEL:
     case KC_UNDS:
@@ -471,7 +478,6 @@ char sentence_case_press_user(uint16_t keycode, keyrecord_t* record,
   if ((mods & ~(MOD_MASK_SHIFT | MOD_BIT_RALT)) == 0) {
     const bool shifted = mods & MOD_MASK_SHIFT;
     switch (keycode) {
-      case KC_A ... KC_Z:
       case M_THE:
       case M_ION:
       case M_MENT:
@@ -479,26 +485,23 @@ char sentence_case_press_user(uint16_t keycode, keyrecord_t* record,
         return 'a';  // Letter key.
 
       case KC_DOT:  // Both . and Shift . (?) punctuate sentence endings.
-      case KC_EXLM:
-      case KC_QUES:
         return '.';
 
       case KC_COMM:
         return shifted ? '.' : '#';
+    }
 
-      case KC_2 ... KC_0:  // 2 3 4 5 6 7 8 9 0
-      case KC_AT ... KC_RPRN:  // @ # $ % ^ & * ( )
-      case KC_MINS ... KC_SCLN:  // - = [ ] backslash ;
-      case KC_UNDS ... KC_COLN:  // _ + { } | :
-      case KC_GRV:
-        return '#';  // Symbol key.
-
-      case KC_SPC:
-        return ' ';  // Space key.
-
-      case KC_QUOT:
-      case KC_DQUO:
-        return '\'';  // Quote key.
+    const uint8_t flags = get_typed_keycode_class(keycode, shifted);
+    if (flags & KEYCODE_CLASS_ALPHA) {
+      return 'a';  // Letter key.
+    } else if (flags & KEYCODE_CLASS_ENDING) {
+      return '.';  // ! ?
+    } else if (flags & KEYCODE_CLASS_SYMBOL) {
+      return '#';  // Symbol key.
+    } else if (flags & KEYCODE_CLASS_SPACE) {
+      return ' ';  // Space key.
+    } else if (flags & KEYCODE_CLASS_QUOTE) {
+      return '\'';  // Quote or double quote key.
     }
   }
 
@@ -734,7 +737,11 @@ static void lighting_preset(uint8_t effect, uint8_t palette) {
 ///////////////////////////////////////////////////////////////////////////////
 // Debug logging
 ///////////////////////////////////////////////////////////////////////////////
-#ifndef NO_DEBUG
+#if defined(EVENT_TRACE_ENABLE) && !defined(NO_DEBUG)
+#pragma message "dlog_record: event trace"
+// Key events are logged as compact binary records, see features/event_trace.h.
+#define dlog_record(keycode, record) process_event_trace((keycode), (record))
+#elif !defined(NO_DEBUG)
 #pragma message "dlog_record: enabled"
 
 #ifdef KEYCODE_STRING_ENABLE
@@ -766,10 +773,15 @@ static void dlog_record(uint16_t keycode, keyrecord_t* record) {
   } else {  // Log the "(row,col)" position.
     xprintf("(%2u,%2u) ", record->event.key.row, record->event.key.col);
   }
-  xprintf("%-4s %-7s %s\n",  // "(tap|hold) (press|release) <keycode>".
+  xprintf("%-4s %-7s ",  // "(tap|hold) (press|release) <keycode>".
       is_tap_hold ? (record->tap.count ? "tap" : "hold") : "",
-      record->event.pressed ? "press" : "release",
-      get_keycode_string(keycode));
+      record->event.pressed ? "press" : "release");
+#ifdef KEYCODE_STRING_NUMERIC
+  // Named on the host, with tools/host_sim/trace_decode -t.
+  xprintf("0x%04X\n", keycode);
+#else
+  xprintf("%s\n", get_keycode_string(keycode));
+#endif  // KEYCODE_STRING_NUMERIC
 }
 #else
 #pragma message "dlog_record: disabled"
@@ -821,6 +833,12 @@ void keyboard_post_init_user(void) {
 #endif // defined(AUDIO_ENABLE) && defined(MUSHROOM_SOUND)
 }
 
+#ifdef EVENT_TRACE_ENABLE
+void housekeeping_task_user(void) {
+  event_trace_task();
+}
+#endif  // EVENT_TRACE_ENABLE
+
 bool process_record_user(uint16_t keycode, keyrecord_t* record) {
   dlog_record(keycode, record);
 
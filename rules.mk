@@ -30,3 +30,49 @@ NKRO_ENABLE ?= no
 SPACE_CADET_ENABLE ?= no
 TAP_DANCE_ENABLE ?= no
 
+# Keycode classification table used by the Caps Word and Sentence Case
+# callbacks, see features/keycode_class.h.
+SRC += features/keycode_class.c
+
+# Tapping terms learned from typing, see features/adaptive_term.h. Enable with
+# `qmk compile ... -e ADAPTIVE_TERM_ENABLE=yes`.
+ADAPTIVE_TERM_ENABLE ?= no
+ifeq ($(strip $(ADAPTIVE_TERM_ENABLE)), yes)
+  OPT_DEFS += -DADAPTIVE_TERM_ENABLE
+  SRC += features/adaptive_term.c
+endif
+
+# Compact binary key event logging in place of dlog_record's text, see
+# features/event_trace.h. Enable with `qmk compile ... -e EVENT_TRACE_ENABLE=yes`.
+EVENT_TRACE_ENABLE ?= no
+ifeq ($(strip $(EVENT_TRACE_ENABLE)), yes)
+  OPT_DEFS += -DEVENT_TRACE_ENABLE
+  SRC += features/event_trace.c
+endif
+
+# Log keycodes as hex values rather than names. This leaves out keycode_string
+# and its name tables, saving flash on the keymaps that log with it, those with
+# CONSOLE_ENABLE and KEYCODE_STRING_ENABLE (the ZSA keymaps). Names are
+# recovered on the host with tools/host_sim/trace_decode -t. Enable with
+# `qmk compile ... -e KEYCODE_STRING_NUMERIC=yes`.
+KEYCODE_STRING_NUMERIC ?= no
+ifeq ($(strip $(KEYCODE_STRING_NUMERIC)), yes)
+  OPT_DEFS += -DKEYCODE_STRING_NUMERIC
+  KEYCODE_STRING_ENABLE = no
+endif
+
+# Per-handler latency profiling, see features/handler_profile.h. Enable with
+# `qmk compile ... -e HANDLER_PROFILE_ENABLE=yes`.
+HANDLER_PROFILE_ENABLE ?= no
+ifeq ($(strip $(HANDLER_PROFILE_ENABLE)), yes)
+  OPT_DEFS += -DHANDLER_PROFILE_ENABLE
+  SRC += features/handler_profile.c
+  # Handlers are wrapped at link time, which LTO would defeat.
+  LTO_ENABLE = no
+  HANDLER_PROFILE_WRAPPED = process_caps_word process_layer_lock \
+      process_repeat_key process_autocorrect process_record_sentence_case \
+      process_record_select_word process_record_custom_shift_keys
+  handler_profile_comma := ,
+  EXTRALDFLAGS += $(foreach f,$(HANDLER_PROFILE_WRAPPED), \
+      -Wl$(handler_profile_comma)--wrap=$(f))
+endif
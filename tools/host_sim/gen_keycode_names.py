@@ -0,0 +1,104 @@
+# Copyright 2025 Google LLC
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     https://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""Generates the keymap's keycode names for trace_decode."""
+import re
+import sys
+from typing import List
+
+HELP_TEXT = """Generate keycode names for trace_decode.
+Use: python3 gen_keycode_names.py keymap.c > keycode_names.h
+
+Extracts the `custom_keycodes` enum and the KEYCODE_STRING_NAMES_USER entries
+from a keymap, such as anarion.c or getreuer.c, and writes them as a header
+that defines KEYCODE_STRING_NAMES_USER. Together with the common names in
+features/keycode_string.c, this lets trace_decode name the keycodes that a
+keymap built with KEYCODE_STRING_NUMERIC logs as hex values.
+
+Entries of KEYCODE_STRING_NAMES_USER that are not custom keycodes, such as
+community module keycodes, have no known value on the host and are skipped.
+"""
+
+
+def strip_comments(source: str) -> str:
+  """Removes C comments from `source`, keeping line breaks."""
+  return re.sub(
+      r'//[^\n]*|/\*.*?\*/',
+      lambda m: '\n' * m.group(0).count('\n'),
+      source,
+      flags=re.DOTALL)
+
+
+def parse_custom_keycodes(source: str) -> List[str]:
+  """Returns the enumerators of the `custom_keycodes` enum, in order."""
+  match = re.search(r'\benum\s+custom_keycodes\s*\{(.*?)\}', source, re.DOTALL)
+  if not match:
+    return []
+  names = []
+  for item in match.group(1).split(','):
+    name = item.split('=', 1)[0].strip()
+    if name:
+      names.append(name)
+  return names
+
+
+def parse_user_names(source: str) -> List[str]:
+  """Returns the keycodes named in KEYCODE_STRING_NAMES_USER, in order."""
+  match = re.search(r'\bKEYCODE_STRING_NAMES_USER\s*\((.*?)\)\s*;',
+                    source, re.DOTALL)
+  if not match:
+    return []
+  return re.findall(r'KEYCODE_STRING_NAME\s*\(\s*(\w+)\s*\)', match.group(1))
+
+
+def generate(keymap_file_name: str) -> str:
+  """Generates the header for the keymap `keymap_file_name`."""
+  source = strip_comments(open(keymap_file_name, 'rt').read())
+  match = re.search(r'\benum\s+custom_keycodes\s*\{.*?\}\s*;', source,
+                    re.DOTALL)
+  custom_keycodes = parse_custom_keycodes(source)
+  names = list(custom_keycodes)
+  skipped = []
+  for name in parse_user_names(source):
+    if name not in custom_keycodes:
+      skipped.append(name)
+
+  lines = [
+      f'// Generated by gen_keycode_names.py from {keymap_file_name}.',
+      '// Do not edit.',
+      '',
+      '#pragma once',
+      '',
+  ]
+  if match:
+    lines.append(match.group(0))
+    lines.append('')
+  if skipped:
+    lines.append(f'// Skipped, not custom keycodes: {", ".join(skipped)}')
+  lines.append('KEYCODE_STRING_NAMES_USER(')
+  lines.extend(f'  KEYCODE_STRING_NAME({name}),' for name in names)
+  lines.append(');')
+  return '\n'.join(lines) + '\n'
+
+
+def main(argv):
+  if len(argv) != 2 or argv[1].startswith('-'):
+    print(HELP_TEXT)
+    sys.exit(1)
+
+  print(generate(argv[1]), end='')
+
+
+if __name__ == '__main__':
+  main(sys.argv)
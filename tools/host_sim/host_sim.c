@@ -0,0 +1,683 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file host_sim.c
+ * @brief Host-native replay of key event streams through features/
+ *
+ * Builds the modules in features/ against a stubbed QMK core (quantum.h,
+ * qmk_stub.c) and replays recorded key event streams through a handler chain
+ * like the one in a keymap's process_record_user(). For each run, it reports
+ * the keyboard and mouse reports sent to the host, the resulting typed text,
+ * and per-handler timings in nanoseconds. This makes it possible to step
+ * through and profile the modules with ordinary host tools (gdb, perf,
+ * sanitizers) rather than on the keyboard.
+ *
+ * Usage:
+ *
+ *     make
+ *     ./host_sim [-q] [-v] [-r repeats] [stream.txt ...]
+ *
+ * With no stream files, events are read from stdin. Options:
+ *
+ *   -q  Quiet: don't print reports, only the typed text and timings.
+ *   -v  Verbose: also print console output (dprintf etc.) of the modules.
+ *   -r  Replay the streams `repeats` times, e.g. for steadier timings.
+ *
+ * With -v, the console output includes Event Trace records, which `make
+ * trace_decode` builds a decoder for: `./host_sim -v s.txt | ./trace_decode`.
+ *
+ * Stream format, one event or directive per line, '#' starts a comment:
+ *
+ *     <time> <d|u> <row> <col> <keycode> [<tap count>]
+ *         A key event, as in keyrecord_t. `time` is in milliseconds, either
+ *         absolute or relative to the previous line as "+ms". `keycode` is a
+ *         number, decimal or 0x-prefixed hex. On press, the tap count of a
+ *         tap-hold key says how QMK settled it: 0 for hold, >= 1 for tap.
+ *
+ *     type <interval> <text>
+ *         Taps keys to type `text`, one key every `interval` ms. Escapes \b
+ *         (backspace) and \n (enter) are recognized.
+ *
+ *     wait <ms>
+ *         Lets `ms` milliseconds pass, running the housekeeping tasks.
+ *
+ *     expect <text>
+ *         Checks that the text typed so far ends with `text`. A failed
+ *         expectation is reported and makes host_sim exit with status 1.
+ *
+ *     expect_mouse <x> <y> [<tolerance>]
+ *         Checks that the mouse pointer, summing the reports' x and y deltas,
+ *         is within `tolerance` pixels (default 0) of (x, y) relative to
+ *         where it was at the start of the stream or the last `mark_mouse`.
+ *
+ *     mark_mouse
+ *         Makes the current mouse pointer position the origin for
+ *         `expect_mouse`.
+ *
+ *     eeprom <offset> <byte> ...
+ *         Writes bytes to the EEPROM user data block at `offset`, for instance
+ *         to give a module saved data before it first loads it.
+ *
+ *     expect_eeprom <offset> <byte> ...
+ *         Checks the bytes of the EEPROM user data block at `offset`.
+ *
+ *     expect_term <keycode> <ms>
+ *         Checks the tapping term that Adaptive Term derives for `keycode`,
+ *         with a default of TAPPING_TERM.
+ *
+ * Simulated time advances in 1 ms steps, calling the modules' tasks each step
+ * as QMK's housekeeping would.
+ */
+
+#include <ctype.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "features/achordion.h"
+#include "features/adaptive_term.h"
+#include "features/autocorrection.h"
+#include "features/caps_word.h"
+#include "features/custom_shift_keys.h"
+#include "features/event_trace.h"
+#include "features/keycode_string.h"
+#include "features/layer_lock.h"
+#include "features/orbital_mouse.h"
+#include "features/repeat_key.h"
+#include "features/select_word.h"
+#include "features/sentence_case.h"
+#include "features/socd_cleaner.h"
+#include "qmk_stub.h"
+
+///////////////////////////////////////////////////////////////////////////////
+// Simulated keymap
+///////////////////////////////////////////////////////////////////////////////
+
+enum custom_keycodes {
+  REPEAT = SAFE_RANGE,
+  ALTREP,
+  LLOCK,
+  SELWORD,
+};
+
+uint16_t SELECT_WORD_KEYCODE = SELWORD;
+
+const custom_shift_key_t custom_shift_keys[] = {
+    {KC_DOT, KC_QUES},
+    {KC_COMM, KC_EXLM},
+};
+uint8_t NUM_CUSTOM_SHIFT_KEYS =
+    sizeof(custom_shift_keys) / sizeof(custom_shift_key_t);
+
+// LCTL_T(KC_F) is left to streams/adaptive_term.txt, which other streams'
+// samples would disturb.
+const uint16_t adaptive_term_keys[] = {LSFT_T(KC_A), LSFT_T(KC_S),
+                                       LCTL_T(KC_F)};
+uint8_t NUM_ADAPTIVE_TERM_KEYS =
+    sizeof(adaptive_term_keys) / sizeof(*adaptive_term_keys);
+
+static socd_cleaner_t socd_h = {{KC_LEFT, KC_RGHT}, SOCD_CLEANER_LAST};
+
+KEYCODE_STRING_NAMES_USER(KEYCODE_STRING_NAME(REPEAT),
+                          KEYCODE_STRING_NAME(ALTREP),
+                          KEYCODE_STRING_NAME(LLOCK),
+                          KEYCODE_STRING_NAME(SELWORD), );
+
+// Formats each keycode as the keymaps' debug logging does, streaming it to the
+// console. Without debug, the keycode is formatted into a local buffer, so
+// that its cost is timed either way.
+static bool handle_keycode_string(uint16_t keycode, keyrecord_t* record) {
+  if (debug_enable) {
+    dprintf("%-7s ", record->event.pressed ? "press" : "release");
+    print_keycode_string(keycode);
+    dprintf("\n");
+  } else {
+    char name[KEYCODE_STRING_MAX_LEN + 1];
+    get_keycode_string_r(keycode, name, sizeof(name));
+  }
+  return true;
+}
+
+static bool handle_event_trace(uint16_t keycode, keyrecord_t* record) {
+  process_event_trace(keycode, record);
+  return true;
+}
+
+// Whether the event being handled comes from the stream, rather than being
+// replayed by Achordion.
+static bool is_stream_event = false;
+
+// Adaptive Term observes the key events as QMK settled them, as in anarion.c,
+// which has no Achordion ahead of it. Achordion's replays are skipped, as they
+// would count the same keys again with the times of the original presses.
+static bool handle_adaptive_term(uint16_t keycode, keyrecord_t* record) {
+  if (is_stream_event) {
+    process_adaptive_term(keycode, record);
+  }
+  return true;
+}
+
+static bool handle_layer_lock(uint16_t keycode, keyrecord_t* record) {
+  return process_layer_lock(keycode, record, LLOCK);
+}
+
+static bool handle_repeat_key(uint16_t keycode, keyrecord_t* record) {
+  return process_repeat_key_with_alt(keycode, record, REPEAT, ALTREP);
+}
+
+static bool handle_socd_cleaner(uint16_t keycode, keyrecord_t* record) {
+  return process_socd_cleaner(keycode, record, &socd_h);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Timed handler chain
+///////////////////////////////////////////////////////////////////////////////
+
+typedef struct {
+  const char* name;
+  uint32_t calls;
+  uint64_t total_ns;
+  uint64_t max_ns;
+} timing_t;
+
+typedef struct {
+  timing_t timing;
+  bool (*process)(uint16_t keycode, keyrecord_t* record);
+} handler_t;
+
+typedef struct {
+  timing_t timing;
+  void (*task)(void);
+} task_t;
+
+// Handlers in the order process_record_user() calls them.
+static handler_t handlers[] = {
+    {{"keycode_string"}, handle_keycode_string},
+    {{"event_trace"}, handle_event_trace},
+    {{"adaptive_term"}, handle_adaptive_term},
+    {{"achordion"}, process_achordion},
+    {{"layer_lock"}, handle_layer_lock},
+    {{"repeat_key"}, handle_repeat_key},
+    {{"autocorrection"}, process_autocorrection},
+    {{"caps_word"}, process_caps_word},
+    {{"sentence_case"}, process_sentence_case},
+    {{"select_word"}, process_select_word},
+    {{"custom_shift_keys"}, process_custom_shift_keys},
+    {{"socd_cleaner"}, handle_socd_cleaner},
+    {{"orbital_mouse"}, process_orbital_mouse},
+};
+#define NUM_HANDLERS (sizeof(handlers) / sizeof(*handlers))
+
+static task_t tasks[] = {
+    {{"event_trace_task"}, event_trace_task},
+    {{"achordion_task"}, achordion_task},
+    {{"adaptive_term_task"}, adaptive_term_task},
+#if CAPS_WORD_IDLE_TIMEOUT > 0
+    {{"caps_word_task"}, caps_word_task},
+#endif  // CAPS_WORD_IDLE_TIMEOUT > 0
+#if LAYER_LOCK_IDLE_TIMEOUT > 0
+    {{"layer_lock_task"}, layer_lock_task},
+#endif  // LAYER_LOCK_IDLE_TIMEOUT > 0
+#if SELECT_WORD_TIMEOUT > 0
+    {{"select_word_task"}, select_word_task},
+#endif  // SELECT_WORD_TIMEOUT > 0
+#if SENTENCE_CASE_TIMEOUT > 0
+    {{"sentence_case_task"}, sentence_case_task},
+#endif  // SENTENCE_CASE_TIMEOUT > 0
+    {{"orbital_mouse_task"}, orbital_mouse_task},
+};
+#define NUM_TASKS (sizeof(tasks) / sizeof(*tasks))
+
+static uint64_t now_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * UINT64_C(1000000000) + (uint64_t)ts.tv_nsec;
+}
+
+// Cost of the now_ns() pair around each call, subtracted from timings.
+static uint64_t overhead_ns = 0;
+
+static void calibrate_overhead(void) {
+  enum { NUM_SAMPLES = 10000 };
+  uint64_t total_ns = 0;
+  for (int i = 0; i < NUM_SAMPLES; ++i) {
+    const uint64_t start = now_ns();
+    total_ns += now_ns() - start;
+  }
+  overhead_ns = total_ns / NUM_SAMPLES;
+}
+
+// Handlers may reentrantly process events, as Achordion and Repeat Key do.
+// Time spent in nested handler calls is subtracted from the enclosing call, so
+// that each handler is charged only for its own work.
+#define MAX_DEPTH 16
+static uint64_t nested_ns[MAX_DEPTH + 1] = {0};
+static uint8_t depth = 0;
+
+static void record_timing(timing_t* timing, uint64_t elapsed_ns) {
+  elapsed_ns = (elapsed_ns > overhead_ns) ? elapsed_ns - overhead_ns : 0;
+  const uint64_t self_ns = (elapsed_ns > nested_ns[depth])
+                               ? elapsed_ns - nested_ns[depth] : 0;
+  --depth;
+  nested_ns[depth] += elapsed_ns;
+  ++timing->calls;
+  timing->total_ns += self_ns;
+  if (self_ns > timing->max_ns) {
+    timing->max_ns = self_ns;
+  }
+}
+
+static void begin_timing(void) {
+  if (depth >= MAX_DEPTH) {
+    fprintf(stderr, "Error: handlers nested deeper than %d.\n", MAX_DEPTH);
+    exit(1);
+  }
+  nested_ns[++depth] = 0;
+}
+
+bool process_record_user(uint16_t keycode, keyrecord_t* record) {
+  for (uint8_t i = 0; i < NUM_HANDLERS; ++i) {
+    begin_timing();
+    const uint64_t start = now_ns();
+    const bool result = handlers[i].process(keycode, record);
+    record_timing(&handlers[i].timing, now_ns() - start);
+    if (!result) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static void run_tasks(void) {
+  for (uint8_t i = 0; i < NUM_TASKS; ++i) {
+    begin_timing();
+    const uint64_t start = now_ns();
+    tasks[i].task();
+    record_timing(&tasks[i].timing, now_ns() - start);
+  }
+}
+
+static void print_timing(const timing_t* timing) {
+  if (!timing->calls) {
+    return;
+  }
+  printf("%-20s %10" PRIu32 " %10.1f %10" PRIu64 " %12.1f\n", timing->name,
+         timing->calls, (double)timing->total_ns / timing->calls,
+         timing->max_ns, timing->total_ns / 1e3);
+}
+
+static void print_timings(void) {
+  printf("\nTimings, less %" PRIu64 " ns clock overhead per call:\n",
+         overhead_ns);
+  printf("%-20s %10s %10s %10s %12s\n", "handler", "calls", "mean ns",
+         "max ns", "total us");
+  for (uint8_t i = 0; i < NUM_HANDLERS; ++i) {
+    print_timing(&handlers[i].timing);
+  }
+  for (uint8_t i = 0; i < NUM_TASKS; ++i) {
+    print_timing(&tasks[i].timing);
+  }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Host side: report logging and typed text
+///////////////////////////////////////////////////////////////////////////////
+
+static bool quiet = false;
+static char typed[1 << 16];
+static size_t typed_len = 0;
+// Mouse pointer position, the sum of all mouse report deltas.
+static int32_t mouse_x = 0;
+static int32_t mouse_y = 0;
+
+static void type_char(char c) {
+  if (typed_len + 1 >= sizeof(typed)) {  // Drop the older half when full.
+    memmove(typed, typed + sizeof(typed) / 2, sizeof(typed) / 2);
+    typed_len -= sizeof(typed) / 2;
+  }
+  typed[typed_len++] = c;
+  typed[typed_len] = '\0';
+}
+
+void host_sim_on_keyboard_report(const host_sim_report_t* prev,
+                                 const host_sim_report_t* report) {
+  if (!quiet) {
+    printf("%8" PRIu32 " kbd   mods=%02x keys=", host_sim_time(),
+           report->mods);
+    for (int code = 0; code < 256; ++code) {
+      if (report->keys[code / 8] & (1 << (code % 8))) {
+        printf("%02x ", code);
+      }
+    }
+    printf("\n");
+  }
+
+  // Update the typed text with keys that were newly pressed.
+  const bool shifted = (report->mods & MOD_MASK_SHIFT) != 0;
+  const bool shortcut = (report->mods & ~MOD_MASK_SHIFT) != 0;
+  for (int code = 0; code < 256; ++code) {
+    const uint8_t bit = 1 << (code % 8);
+    if (!(report->keys[code / 8] & bit) || (prev->keys[code / 8] & bit) ||
+        shortcut) {
+      continue;
+    }
+    if (code == KC_BSPC) {
+      if (typed_len > 0) {
+        typed[--typed_len] = '\0';
+      }
+    } else {
+      const char c = host_sim_keycode_to_ascii(code, shifted);
+      if (c) {
+        type_char(c);
+      }
+    }
+  }
+}
+
+void host_sim_on_mouse_report(const report_mouse_t* report) {
+  if (!quiet) {
+    printf("%8" PRIu32 " mouse buttons=%02x x=%d y=%d v=%d h=%d\n",
+           host_sim_time(), report->buttons, report->x, report->y, report->v,
+           report->h);
+  }
+  mouse_x += report->x;
+  mouse_y += report->y;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Stream replay
+///////////////////////////////////////////////////////////////////////////////
+
+static int failures = 0;
+
+static void advance_to(uint32_t time) {
+  while ((int32_t)(time - host_sim_time()) > 0) {
+    host_sim_set_time(host_sim_time() + 1);
+    run_tasks();
+  }
+}
+
+static void send_event(uint8_t row, uint8_t col, bool pressed,
+                       uint16_t keycode, uint8_t tap_count) {
+  keyrecord_t record = {
+      .event = MAKE_KEYEVENT(row, col, pressed),
+      .keycode = keycode,
+  };
+  record.tap.count = tap_count;
+  is_stream_event = true;
+  process_record(&record);
+  is_stream_event = false;
+}
+
+static void type_text(uint32_t interval, const char* text) {
+  for (; *text; ++text) {
+    char c = *text;
+    if (c == '\\' && text[1]) {
+      ++text;
+      c = (*text == 'b') ? '\b' : (*text == 'n') ? '\n' : *text;
+    }
+    const uint16_t keycode = host_sim_ascii_to_keycode(c);
+    if (keycode == KC_NO) {
+      continue;
+    }
+    // Give each key a distinct matrix position, derived from its keycode.
+    const uint8_t row = (keycode >> 3) & 7;
+    const uint8_t col = keycode & 7;
+    const uint32_t start = host_sim_time();
+    send_event(row, col, true, keycode, 1);
+    advance_to(start + interval / 2);
+    send_event(row, col, false, keycode, 1);
+    advance_to(start + interval);
+  }
+}
+
+static void expect_text(const char* expected, const char* name, int line) {
+  const size_t len = strlen(expected);
+  if (len > typed_len || strcmp(typed + typed_len - len, expected) != 0) {
+    fprintf(stderr, "%s:%d: expected \"%s\" but typed text ends \"%s\"\n",
+            name, line, expected,
+            typed + (typed_len > len + 8 ? typed_len - len - 8 : 0));
+    ++failures;
+  }
+}
+
+// Mouse pointer position at the start of the current stream, or where it was
+// marked with `mark_mouse`.
+static int32_t stream_mouse_x = 0;
+static int32_t stream_mouse_y = 0;
+
+static bool expect_mouse(const char* args, const char* name, int line) {
+  long x, y, tolerance = 0;
+  if (sscanf(args, "%ld %ld %ld", &x, &y, &tolerance) < 2) {
+    return false;
+  }
+  const long dx = mouse_x - stream_mouse_x;
+  const long dy = mouse_y - stream_mouse_y;
+  if (labs(dx - x) > tolerance || labs(dy - y) > tolerance) {
+    fprintf(stderr, "%s:%d: expected mouse at (%ld, %ld) but it is at "
+            "(%ld, %ld)\n", name, line, x, y, dx, dy);
+    ++failures;
+  }
+  return true;
+}
+
+// Parses the offset and up to `max_bytes` bytes of an `eeprom` or
+// `expect_eeprom` directive. Returns the number of bytes, or 0 on error.
+static uint32_t parse_eeprom_args(const char* args, uint32_t* offset,
+                                  uint8_t* bytes, uint32_t max_bytes) {
+  char* end;
+  *offset = strtoul(args, &end, 0);
+  if (end == args) {
+    return 0;
+  }
+  uint32_t n = 0;
+  for (args = end; n < max_bytes; ++n, args = end) {
+    const unsigned long value = strtoul(args, &end, 0);
+    if (end == args) {
+      break;
+    } else if (value > 255) {
+      return 0;
+    }
+    bytes[n] = (uint8_t)value;
+  }
+  return n;
+}
+
+static bool write_eeprom(const char* args) {
+  uint32_t offset;
+  uint8_t bytes[64];
+  const uint32_t n = parse_eeprom_args(args, &offset, bytes, sizeof(bytes));
+  if (!n || offset + n > EECONFIG_USER_DATA_SIZE) {
+    return false;
+  }
+  eeconfig_update_user_datablock(bytes, offset, n);
+  return true;
+}
+
+static bool expect_eeprom(const char* args, const char* name, int line) {
+  uint32_t offset;
+  uint8_t expected[64];
+  const uint32_t n =
+      parse_eeprom_args(args, &offset, expected, sizeof(expected));
+  if (!n || offset + n > EECONFIG_USER_DATA_SIZE) {
+    return false;
+  }
+  uint8_t actual[64];
+  eeconfig_read_user_datablock(actual, offset, n);
+  for (uint32_t k = 0; k < n; ++k) {
+    if (actual[k] != expected[k]) {
+      fprintf(stderr, "%s:%d: expected EEPROM byte %" PRIu32 " to be %u but "
+              "it is %u\n", name, line, offset + k, expected[k], actual[k]);
+      ++failures;
+      break;
+    }
+  }
+  return true;
+}
+
+static bool expect_term(const char* args, const char* name, int line) {
+  unsigned keycode, expected;
+  if (sscanf(args, "%i %u", (int*)&keycode, &expected) < 2) {
+    return false;
+  }
+  const uint16_t term = adaptive_term_tapping_term(keycode, TAPPING_TERM);
+  if (term != expected) {
+    fprintf(stderr, "%s:%d: expected tapping term %u ms for 0x%04X but it is "
+            "%u ms\n", name, line, expected, keycode, term);
+    ++failures;
+  }
+  return true;
+}
+
+static char* trim(char* s) {
+  while (isspace((unsigned char)*s)) {
+    ++s;
+  }
+  char* end = s + strlen(s);
+  while (end > s && isspace((unsigned char)end[-1])) {
+    *--end = '\0';
+  }
+  return s;
+}
+
+// Replays one line of a stream. Returns false on a syntax error.
+static bool replay_line(char* line, uint32_t* prev_time, uint32_t offset,
+                        const char* name, int line_number) {
+  char* hash = strchr(line, '#');
+  if (hash && strncmp(line, "type", 4) != 0 &&
+      strncmp(line, "expect", 6) != 0) {
+    *hash = '\0';
+  }
+  line = trim(line);
+  if (!*line) {
+    return true;
+  }
+
+  char* rest;
+  if (strncmp(line, "type ", 5) == 0) {
+    const uint32_t interval = strtoul(line + 5, &rest, 10);
+    type_text(interval, trim(rest));
+    *prev_time = host_sim_time() - offset;
+    return true;
+  } else if (strncmp(line, "wait ", 5) == 0) {
+    advance_to(host_sim_time() + strtoul(line + 5, NULL, 10));
+    *prev_time = host_sim_time() - offset;
+    return true;
+  } else if (strncmp(line, "expect_mouse ", 13) == 0) {
+    return expect_mouse(line + 13, name, line_number);
+  } else if (strcmp(line, "mark_mouse") == 0) {
+    stream_mouse_x = mouse_x;
+    stream_mouse_y = mouse_y;
+    return true;
+  } else if (strncmp(line, "eeprom ", 7) == 0) {
+    return write_eeprom(line + 7);
+  } else if (strncmp(line, "expect_eeprom ", 14) == 0) {
+    return expect_eeprom(line + 14, name, line_number);
+  } else if (strncmp(line, "expect_term ", 12) == 0) {
+    return expect_term(line + 12, name, line_number);
+  } else if (strncmp(line, "expect ", 7) == 0) {
+    expect_text(trim(line + 7), name, line_number);
+    return true;
+  }
+
+  char dir;
+  unsigned row, col, keycode, tap_count = 0;
+  const bool relative = (*line == '+');
+  uint32_t time = strtoul(line + relative, &rest, 10);
+  if (sscanf(rest, " %c %u %u %i %u", &dir, &row, &col, (int*)&keycode,
+             &tap_count) < 4 ||
+      (dir != 'd' && dir != 'u')) {
+    return false;
+  }
+  if (relative) {
+    time += *prev_time;
+  }
+  *prev_time = time;
+  advance_to(offset + time);
+  send_event(row, col, dir == 'd', keycode, tap_count);
+  return true;
+}
+
+static bool replay_file(FILE* file, const char* name) {
+  uint32_t prev_time = 0;
+  const uint32_t offset = host_sim_time();
+  stream_mouse_x = mouse_x;
+  stream_mouse_y = mouse_y;
+  char line[1024];
+  for (int line_number = 1; fgets(line, sizeof(line), file); ++line_number) {
+    if (!replay_line(line, &prev_time, offset, name, line_number)) {
+      fprintf(stderr, "%s:%d: Error: Invalid syntax.\n", name, line_number);
+      return false;
+    }
+  }
+  advance_to(host_sim_time() + 1000);  // Let pending timeouts resolve.
+  return true;
+}
+
+int main(int argc, char** argv) {
+  int repeats = 1;
+  int i = 1;
+  for (; i < argc && argv[i][0] == '-'; ++i) {
+    if (strcmp(argv[i], "-q") == 0) {
+      quiet = true;
+    } else if (strcmp(argv[i], "-v") == 0) {
+      host_sim_console = debug_enable = true;
+    } else if (strcmp(argv[i], "-r") == 0 && i + 1 < argc) {
+      repeats = atoi(argv[++i]);
+    } else {
+      fprintf(stderr,
+              "Usage: %s [-q] [-v] [-r repeats] [stream.txt ...]\n", argv[0]);
+      return 1;
+    }
+  }
+
+  calibrate_overhead();
+  for (int r = 0; r < repeats; ++r) {
+    if (i == argc) {
+      if (r > 0) {
+        break;  // stdin can be replayed only once.
+      }
+      if (!replay_file(stdin, "<stdin>")) {
+        return 1;
+      }
+    }
+    for (int j = i; j < argc; ++j) {
+      FILE* file = fopen(argv[j], "r");
+      if (!file) {
+        fprintf(stderr, "Error: Unable to open \"%s\".\n", argv[j]);
+        return 1;
+      }
+      const bool ok = replay_file(file, argv[j]);
+      fclose(file);
+      if (!ok) {
+        return 1;
+      }
+    }
+  }
+
+  printf("\ntyped: \"");
+  for (size_t k = 0; k < typed_len; ++k) {
+    if (typed[k] == '\n') {
+      printf("\\n");
+    } else {
+      putchar(typed[k]);
+    }
+  }
+  printf("\"\n");
+  printf("mouse: (%" PRId32 ", %" PRId32 ")\n", mouse_x, mouse_y);
+  print_timings();
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,77 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file host_sim_config.h
+ * @brief Keymap config for the host simulation
+ *
+ * Plays the role of a keymap's config.h. Values follow config_getreuer.h, so
+ * the simulated modules behave like they do on the keyboard. Any of these may
+ * be overridden from the command line, e.g. `make CFLAGS_EXTRA=-DFOO=1`.
+ */
+
+#pragma once
+
+#ifndef TAP_CODE_DELAY
+#define TAP_CODE_DELAY 5
+#endif  // TAP_CODE_DELAY
+
+#ifndef TAPPING_TERM
+#define TAPPING_TERM 240
+#endif  // TAPPING_TERM
+
+// Typing streaks, with timeouts learned by Adaptive Term.
+#ifndef ACHORDION_STREAK
+#define ACHORDION_STREAK
+#endif  // ACHORDION_STREAK
+
+// Fewer samples than the default 32, so that streams train it quickly.
+#ifndef ADAPTIVE_TERM_MIN_SAMPLES
+#define ADAPTIVE_TERM_MIN_SAMPLES 8
+#endif  // ADAPTIVE_TERM_MIN_SAMPLES
+
+#ifndef CAPS_WORD_IDLE_TIMEOUT
+#define CAPS_WORD_IDLE_TIMEOUT 5000
+#endif  // CAPS_WORD_IDLE_TIMEOUT
+
+#ifndef LAYER_LOCK_IDLE_TIMEOUT
+#define LAYER_LOCK_IDLE_TIMEOUT 60000
+#endif  // LAYER_LOCK_IDLE_TIMEOUT
+
+#ifndef SENTENCE_CASE_TIMEOUT
+#define SENTENCE_CASE_TIMEOUT 2000
+#endif  // SENTENCE_CASE_TIMEOUT
+
+// Check the abbreviations of features/sentence_case_abbreviations.h.
+#ifndef SENTENCE_CASE_ABBREVIATIONS
+#define SENTENCE_CASE_ABBREVIATIONS
+#endif  // SENTENCE_CASE_ABBREVIATIONS
+
+// N-grams for Alternate Repeat, checked in streams/typing.txt: "h" -> "e",
+// "th" -> "y" (the longer n-gram wins over "h"), and "ght" -> "s".
+#ifndef REPEAT_KEY_ALT_NGRAMS_USER
+#define REPEAT_KEY_ALT_NGRAMS_USER(NGRAM) \
+  NGRAM(KC_E, KC_H)                        \
+  NGRAM(KC_Y, KC_T, KC_H)                  \
+  NGRAM(KC_S, KC_G, KC_H, KC_T)
+#endif  // REPEAT_KEY_ALT_NGRAMS_USER
+
+#ifndef ORBITAL_MOUSE_SPEED_CURVE
+#define ORBITAL_MOUSE_SPEED_CURVE \
+      {24, 24, 24, 32, 62, 72, 72, 72, 72, 72, 72, 72, 72, 72, 72, 72}
+#endif  // ORBITAL_MOUSE_SPEED_CURVE
+
+#ifndef EECONFIG_USER_DATA_SIZE
+#define EECONFIG_USER_DATA_SIZE 512
+#endif  // EECONFIG_USER_DATA_SIZE
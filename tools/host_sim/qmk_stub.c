@@ -0,0 +1,505 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file qmk_stub.c
+ * @brief Stubbed QMK core for building features/ on the host
+ *
+ * Implements the QMK API declared in quantum.h with just enough fidelity to
+ * drive the modules in features/: a simulated millisecond clock, layer state,
+ * real/weak/one-shot mods, an NKRO-style keyboard report, Send String, and the
+ * default action for basic, modified, mod-tap, layer-tap, and layer keys.
+ */
+
+#include "qmk_stub.h"
+
+#include <stdarg.h>
+#include <stdio.h>
+
+bool debug_enable = false;
+bool host_sim_console = false;
+layer_state_t layer_state = 0;
+layer_state_t default_layer_state = 1;
+
+static uint32_t sim_time = 0;
+static uint8_t real_mods = 0;
+static uint8_t weak_mods = 0;
+static uint8_t oneshot_mods = 0;
+static uint8_t oneshot_layer = 0;
+static bool oneshot_layer_active = false;
+static uint8_t keys_down[32] = {0};  // Bitmap of registered basic keycodes.
+static host_sim_report_t last_report = {0};
+
+///////////////////////////////////////////////////////////////////////////////
+// Timers, waits, and debug output
+///////////////////////////////////////////////////////////////////////////////
+
+uint16_t timer_read(void) { return (uint16_t)sim_time; }
+uint32_t timer_read32(void) { return sim_time; }
+uint32_t host_sim_time(void) { return sim_time; }
+void host_sim_set_time(uint32_t time) { sim_time = time; }
+
+// Like QMK's wait_ms(), this blocks: time passes but no tasks run.
+void wait_ms(uint16_t ms) { sim_time += ms; }
+
+int host_sim_printf(const char* fmt, ...) {
+  if (!host_sim_console) {
+    return 0;
+  }
+  va_list args;
+  va_start(args, fmt);
+  const int result = vprintf(fmt, args);
+  va_end(args);
+  return result;
+}
+
+int8_t sendchar(uint8_t c) {
+  if (host_sim_console) {
+    putchar(c);
+  }
+  return 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// EEPROM
+///////////////////////////////////////////////////////////////////////////////
+
+static uint8_t user_datablock[EECONFIG_USER_DATA_SIZE] = {0};
+
+static uint32_t clamp_datablock_length(uint32_t offset, uint32_t length) {
+  if (offset >= sizeof(user_datablock)) {
+    return 0;
+  }
+  return (length < sizeof(user_datablock) - offset)
+             ? length : sizeof(user_datablock) - offset;
+}
+
+uint32_t eeconfig_read_user_datablock(void* data, uint32_t offset,
+                                      uint32_t length) {
+  length = clamp_datablock_length(offset, length);
+  memcpy(data, user_datablock + offset, length);
+  return length;
+}
+
+uint32_t eeconfig_update_user_datablock(const void* data, uint32_t offset,
+                                        uint32_t length) {
+  length = clamp_datablock_length(offset, length);
+  memcpy(user_datablock + offset, data, length);
+  return length;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Layers
+///////////////////////////////////////////////////////////////////////////////
+
+bool layer_state_is(uint8_t layer) {
+  return layer == 0 ? !layer_state : IS_LAYER_ON_STATE(layer_state, layer);
+}
+
+void layer_state_set(layer_state_t state) { layer_state = state; }
+void layer_on(uint8_t layer) { layer_state_set(layer_state | (1UL << layer)); }
+void layer_off(uint8_t layer) {
+  layer_state_set(layer_state & ~(1UL << layer));
+}
+void layer_invert(uint8_t layer) {
+  layer_state_set(layer_state ^ (1UL << layer));
+}
+void layer_and(layer_state_t state) { layer_state_set(layer_state & state); }
+void layer_or(layer_state_t state) { layer_state_set(layer_state | state); }
+void layer_move(uint8_t layer) { layer_state_set(1UL << layer); }
+void layer_clear(void) { layer_state_set(0); }
+
+uint8_t get_highest_layer(layer_state_t state) {
+  uint8_t layer = 0;
+  for (; state >>= 1; ++layer) {
+  }
+  return layer;
+}
+
+// The simulation has no layer cache, so this is the layer the key would be
+// looked up on now.
+uint8_t read_source_layers_cache(keypos_t key) {
+  return get_highest_layer(layer_state | default_layer_state);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Modifiers and keyboard reports
+///////////////////////////////////////////////////////////////////////////////
+
+uint8_t get_mods(void) { return real_mods; }
+void set_mods(uint8_t mods) { real_mods = mods; }
+void add_mods(uint8_t mods) { real_mods |= mods; }
+void del_mods(uint8_t mods) { real_mods &= ~mods; }
+void clear_mods(void) { real_mods = 0; }
+uint8_t get_weak_mods(void) { return weak_mods; }
+void set_weak_mods(uint8_t mods) { weak_mods = mods; }
+void add_weak_mods(uint8_t mods) { weak_mods |= mods; }
+void del_weak_mods(uint8_t mods) { weak_mods &= ~mods; }
+void clear_weak_mods(void) { weak_mods = 0; }
+uint8_t get_oneshot_mods(void) { return oneshot_mods; }
+void set_oneshot_mods(uint8_t mods) { oneshot_mods = mods; }
+void add_oneshot_mods(uint8_t mods) { oneshot_mods |= mods; }
+void del_oneshot_mods(uint8_t mods) { oneshot_mods &= ~mods; }
+void clear_oneshot_mods(void) { oneshot_mods = 0; }
+bool is_oneshot_layer_active(void) { return oneshot_layer_active; }
+uint8_t get_oneshot_layer(void) { return oneshot_layer; }
+
+void clear_oneshot_layer_state(uint8_t state) {
+  if (oneshot_layer_active) {
+    oneshot_layer_active = false;
+    layer_off(oneshot_layer);
+  }
+}
+
+void reset_oneshot_layer(void) { oneshot_layer_active = false; }
+
+led_t host_keyboard_led_state(void) { return (led_t){.raw = 0}; }
+
+const host_sim_report_t* host_sim_keyboard_report(void) {
+  return &last_report;
+}
+
+void send_keyboard_report(void) {
+  host_sim_report_t report = {.mods = real_mods | weak_mods};
+  memcpy(report.keys, keys_down, sizeof(keys_down));
+  if (memcmp(&report, &last_report, sizeof(report)) != 0) {
+    const host_sim_report_t prev = last_report;
+    last_report = report;
+    host_sim_on_keyboard_report(&prev, &report);
+  }
+}
+
+void clear_keyboard(void) {
+  real_mods = weak_mods = oneshot_mods = 0;
+  memset(keys_down, 0, sizeof(keys_down));
+  send_keyboard_report();
+}
+
+void register_mods(uint8_t mods) {
+  add_mods(mods);
+  send_keyboard_report();
+}
+
+void unregister_mods(uint8_t mods) {
+  del_mods(mods);
+  send_keyboard_report();
+}
+
+void register_weak_mods(uint8_t mods) {
+  add_weak_mods(mods);
+  send_keyboard_report();
+}
+
+void unregister_weak_mods(uint8_t mods) {
+  del_weak_mods(mods);
+  send_keyboard_report();
+}
+
+void add_key(uint8_t key) { keys_down[key / 8] |= 1 << (key % 8); }
+void del_key(uint8_t key) { keys_down[key / 8] &= ~(1 << (key % 8)); }
+
+void register_code(uint8_t code) {
+  if (IS_MODIFIER_KEYCODE(code)) {
+    register_mods(MOD_BIT(code));
+    return;
+  } else if (code == KC_NO) {
+    return;
+  }
+  if (oneshot_mods) {  // A one-shot mod applies to this key only.
+    add_weak_mods(oneshot_mods);
+    clear_oneshot_mods();
+  }
+  add_key(code);
+  send_keyboard_report();
+}
+
+void unregister_code(uint8_t code) {
+  if (IS_MODIFIER_KEYCODE(code)) {
+    unregister_mods(MOD_BIT(code));
+    return;
+  }
+  del_key(code);
+  clear_weak_mods();
+  send_keyboard_report();
+}
+
+void tap_code_delay(uint8_t code, uint16_t delay) {
+  register_code(code);
+  wait_ms(delay);
+  unregister_code(code);
+}
+
+void tap_code(uint8_t code) { tap_code_delay(code, TAP_CODE_DELAY); }
+
+// Converts 5-bit packed mods, as in QK_MODS keycodes, to an 8-bit mod mask.
+static uint8_t mod_config_to_mask(uint8_t mods) {
+  return (mods & 0x10) ? ((mods & 0x0f) << 4) : (mods & 0x0f);
+}
+
+void register_code16(uint16_t code) {
+  const uint8_t mods = mod_config_to_mask(QK_MODS_GET_MODS(code));
+  if (mods) {
+    if (IS_MODIFIER_KEYCODE(code & 0xff) || (code & 0xff) == KC_NO) {
+      register_mods(mods);
+    } else {
+      register_weak_mods(mods);
+    }
+  }
+  register_code(code & 0xff);
+}
+
+void unregister_code16(uint16_t code) {
+  unregister_code(code & 0xff);
+  const uint8_t mods = mod_config_to_mask(QK_MODS_GET_MODS(code));
+  if (mods) {
+    if (IS_MODIFIER_KEYCODE(code & 0xff) || (code & 0xff) == KC_NO) {
+      unregister_mods(mods);
+    } else {
+      unregister_weak_mods(mods);
+    }
+  }
+}
+
+void tap_code16_delay(uint16_t code, uint16_t delay) {
+  register_code16(code);
+  wait_ms(delay);
+  unregister_code16(code);
+}
+
+void tap_code16(uint16_t code) { tap_code16_delay(code, TAP_CODE_DELAY); }
+
+///////////////////////////////////////////////////////////////////////////////
+// Mouse reports
+///////////////////////////////////////////////////////////////////////////////
+
+void host_mouse_send(report_mouse_t* report) {
+  host_sim_on_mouse_report(report);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Send String
+///////////////////////////////////////////////////////////////////////////////
+
+// ASCII to keycode lookup for printable characters, starting at ' '. The high
+// bit marks characters that are typed with shift.
+#define SHIFTED 0x80
+static const uint8_t ascii_to_keycode_table[95] = {
+    KC_SPC, KC_1 | SHIFTED, KC_QUOT | SHIFTED, KC_3 | SHIFTED,  // ' '-'#'
+    KC_4 | SHIFTED, KC_5 | SHIFTED, KC_7 | SHIFTED, KC_QUOT,  // '$'-'\''
+    KC_9 | SHIFTED, KC_0 | SHIFTED, KC_8 | SHIFTED, KC_EQL | SHIFTED,  // '('-'+'
+    KC_COMM, KC_MINS, KC_DOT, KC_SLSH,  // ','-'/'
+    KC_0, KC_1, KC_2, KC_3, KC_4, KC_5, KC_6, KC_7, KC_8, KC_9,  // '0'-'9'
+    KC_SCLN | SHIFTED, KC_SCLN, KC_COMM | SHIFTED, KC_EQL,  // ':'-'='
+    KC_DOT | SHIFTED, KC_SLSH | SHIFTED, KC_2 | SHIFTED,  // '>'-'@'
+    KC_A | SHIFTED, KC_B | SHIFTED, KC_C | SHIFTED, KC_D | SHIFTED,
+    KC_E | SHIFTED, KC_F | SHIFTED, KC_G | SHIFTED, KC_H | SHIFTED,
+    KC_I | SHIFTED, KC_J | SHIFTED, KC_K | SHIFTED, KC_L | SHIFTED,
+    KC_M | SHIFTED, KC_N | SHIFTED, KC_O | SHIFTED, KC_P | SHIFTED,
+    KC_Q | SHIFTED, KC_R | SHIFTED, KC_S | SHIFTED, KC_T | SHIFTED,
+    KC_U | SHIFTED, KC_V | SHIFTED, KC_W | SHIFTED, KC_X | SHIFTED,
+    KC_Y | SHIFTED, KC_Z | SHIFTED,  // 'A'-'Z'
+    KC_LBRC, KC_BSLS, KC_RBRC, KC_6 | SHIFTED, KC_MINS | SHIFTED,  // '['-'_'
+    KC_GRV,  // '`'
+    KC_A, KC_B, KC_C, KC_D, KC_E, KC_F, KC_G, KC_H, KC_I, KC_J, KC_K, KC_L,
+    KC_M, KC_N, KC_O, KC_P, KC_Q, KC_R, KC_S, KC_T, KC_U, KC_V, KC_W, KC_X,
+    KC_Y, KC_Z,  // 'a'-'z'
+    KC_LBRC | SHIFTED, KC_BSLS | SHIFTED, KC_RBRC | SHIFTED,  // '{'-'}'
+    KC_GRV | SHIFTED,  // '~'
+};
+
+uint16_t host_sim_ascii_to_keycode(char c) {
+  switch (c) {
+    case '\b':
+      return KC_BSPC;
+    case '\t':
+      return KC_TAB;
+    case '\n':
+      return KC_ENT;
+  }
+  if (' ' <= c && c <= '~') {
+    const uint8_t entry = ascii_to_keycode_table[c - ' '];
+    return (entry & SHIFTED) ? S(entry & ~SHIFTED) : entry;
+  }
+  return KC_NO;
+}
+
+char host_sim_keycode_to_ascii(uint8_t keycode, bool shifted) {
+  switch (keycode) {
+    case KC_ENT:
+      return '\n';
+    case KC_TAB:
+      return '\t';
+  }
+  for (uint8_t i = 0; i < sizeof(ascii_to_keycode_table); ++i) {
+    const uint8_t entry = ascii_to_keycode_table[i];
+    if ((entry & ~SHIFTED) == keycode && !(entry & SHIFTED) == !shifted) {
+      return (char)(' ' + i);
+    }
+  }
+  return '\0';
+}
+
+void send_char(char ascii_code) {
+  tap_code16(host_sim_ascii_to_keycode(ascii_code));
+}
+
+void send_string_with_delay(const char* str, uint8_t interval) {
+  while (*str) {
+    if (*str == SS_QMK_PREFIX) {
+      ++str;
+      const char code = *str++;
+      if (code == SS_DELAY_CODE) {
+        uint16_t ms = 0;
+        for (; '0' <= *str && *str <= '9'; ++str) {
+          ms = 10 * ms + (*str - '0');
+        }
+        if (*str == '|') {
+          ++str;
+        }
+        wait_ms(ms);
+        continue;
+      }
+      // SS_TAP() and friends encode the keycode as a single byte "\xNN".
+      const uint8_t keycode = (uint8_t)*str++;
+      if (code == SS_TAP_CODE) {
+        tap_code(keycode);
+      } else if (code == SS_DOWN_CODE) {
+        register_code(keycode);
+      } else if (code == SS_UP_CODE) {
+        unregister_code(keycode);
+      }
+    } else {
+      send_char(*str++);
+    }
+    if (interval) {
+      wait_ms(interval);
+    }
+  }
+}
+
+void send_string(const char* str) { send_string_with_delay(str, 0); }
+
+///////////////////////////////////////////////////////////////////////////////
+// Event processing
+///////////////////////////////////////////////////////////////////////////////
+
+__attribute__((weak)) uint16_t keymap_key_to_keycode(uint8_t layer,
+                                                     keypos_t key) {
+  return KC_NO;
+}
+
+void process_action(keyrecord_t* record, action_t action) {
+  const uint8_t kind = action.code >> 12;
+  const uint8_t mods = mod_config_to_mask(((kind & 1) ? 0x10 : 0) |
+                                          ((action.code >> 8) & 0xf));
+  const uint8_t key = action.code & 0xff;
+  if (kind == ACT_LMODS_TAP || kind == ACT_RMODS_TAP) {
+    if (record->tap.count) {  // Mod-tap tapped.
+      if (record->event.pressed) {
+        register_code(key);
+      } else {
+        unregister_code(key);
+      }
+    } else if (record->event.pressed) {  // Mod-tap held.
+      register_mods(mods);
+    } else {
+      unregister_mods(mods);
+    }
+  } else if (record->event.pressed) {
+    register_mods(mods);
+    register_code(key);
+  } else {
+    unregister_code(key);
+    unregister_mods(mods);
+  }
+}
+
+// Default handling of a key event, once the handler chain has let it through.
+static void process_keycode_action(uint16_t keycode, keyrecord_t* record) {
+  const bool pressed = record->event.pressed;
+  if (IS_QK_BASIC(keycode) || IS_QK_MODS(keycode)) {
+    if (pressed) {
+      register_code16(keycode);
+    } else {
+      unregister_code16(keycode);
+    }
+  } else if (IS_QK_MOD_TAP(keycode)) {
+    if (record->tap.count) {
+      if (pressed) {
+        register_code(QK_MOD_TAP_GET_TAP_KEYCODE(keycode));
+      } else {
+        unregister_code(QK_MOD_TAP_GET_TAP_KEYCODE(keycode));
+      }
+    } else {
+      const uint8_t mods = mod_config_to_mask(QK_MOD_TAP_GET_MODS(keycode));
+      if (pressed) {
+        register_mods(mods);
+      } else {
+        unregister_mods(mods);
+      }
+    }
+  } else if (IS_QK_LAYER_TAP(keycode)) {
+    if (record->tap.count) {
+      if (pressed) {
+        register_code(QK_LAYER_TAP_GET_TAP_KEYCODE(keycode));
+      } else {
+        unregister_code(QK_LAYER_TAP_GET_TAP_KEYCODE(keycode));
+      }
+    } else if (pressed) {
+      layer_on(QK_LAYER_TAP_GET_LAYER(keycode));
+    } else {
+      layer_off(QK_LAYER_TAP_GET_LAYER(keycode));
+    }
+  } else if (IS_QK_MOMENTARY(keycode)) {
+    if (pressed) {
+      layer_on(QK_MOMENTARY_GET_LAYER(keycode));
+    } else {
+      layer_off(QK_MOMENTARY_GET_LAYER(keycode));
+    }
+  } else if (IS_QK_TOGGLE_LAYER(keycode)) {
+    if (pressed) {
+      layer_invert(QK_TOGGLE_LAYER_GET_LAYER(keycode));
+    }
+  } else if (IS_QK_TO(keycode)) {
+    if (pressed) {
+      layer_move(QK_TO_GET_LAYER(keycode));
+    }
+  } else if (IS_QK_ONE_SHOT_MOD(keycode)) {
+    if (pressed) {
+      add_oneshot_mods(mod_config_to_mask(QK_ONE_SHOT_MOD_GET_MODS(keycode)));
+    }
+  } else if (IS_QK_ONE_SHOT_LAYER(keycode)) {
+    if (pressed) {
+      oneshot_layer = QK_ONE_SHOT_LAYER_GET_LAYER(keycode);
+      oneshot_layer_active = true;
+      layer_on(oneshot_layer);
+    }
+  }
+}
+
+void process_record(keyrecord_t* record) {
+  uint16_t keycode = record->keycode;
+  if (!keycode) {
+    keycode = keymap_key_to_keycode(get_highest_layer(layer_state),
+                                    record->event.key);
+  }
+  if (process_record_user(keycode, record)) {
+    const bool was_oneshot_layer =
+        oneshot_layer_active && !IS_QK_ONE_SHOT_LAYER(keycode);
+    process_keycode_action(keycode, record);
+    if (was_oneshot_layer && record->event.pressed) {
+      clear_oneshot_layer_state(ONESHOT_PRESSED);
+    }
+  }
+}
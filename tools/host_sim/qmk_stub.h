@@ -0,0 +1,61 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file qmk_stub.h
+ * @brief Simulation controls of the stubbed QMK core
+ *
+ * Functions through which the replay driver steers the simulated keyboard and
+ * observes what it sends to the host. These have no counterpart in QMK.
+ */
+
+#pragma once
+
+#include "quantum.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Keyboard report as seen by the host: mods plus a bitmap of held keys. */
+typedef struct {
+  uint8_t mods;
+  uint8_t keys[32];
+} host_sim_report_t;
+
+/** When true, console output (xprintf, dprintf, ...) goes to stdout. */
+extern bool host_sim_console;
+
+/** Gets the simulated time in milliseconds. */
+uint32_t host_sim_time(void);
+/** Sets the simulated time in milliseconds. */
+void host_sim_set_time(uint32_t time);
+
+/** Gets the most recently sent keyboard report. */
+const host_sim_report_t* host_sim_keyboard_report(void);
+
+/** Gets the keycode that types `c`, possibly shifted as in S(KC_1). */
+uint16_t host_sim_ascii_to_keycode(char c);
+/** Gets the character typed by `keycode`, or '\0' if none. */
+char host_sim_keycode_to_ascii(uint8_t keycode, bool shifted);
+
+/** Called by the stub whenever the keyboard report changes. */
+void host_sim_on_keyboard_report(const host_sim_report_t* prev,
+                                 const host_sim_report_t* report);
+/** Called by the stub for every mouse report sent. */
+void host_sim_on_mouse_report(const report_mouse_t* report);
+
+#ifdef __cplusplus
+}
+#endif
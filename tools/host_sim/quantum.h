@@ -0,0 +1,777 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file quantum.h
+ * @brief Stubbed QMK core for building features/ on the host
+ *
+ * This header stands in for QMK's quantum.h when compiling the modules in
+ * features/ as a native program. It declares the subset of the QMK API that
+ * the modules use: keycodes and keycode range macros, keyrecord_t, modifier
+ * and report functions, timers, layers, and Send String. Keycode values match
+ * QMK's so that keycodes in recorded streams can be replayed as is.
+ *
+ * The implementation lives in qmk_stub.c. Timers run on a simulated clock
+ * that the replay driver advances, and every keyboard or mouse report sent is
+ * passed to the driver for logging (see qmk_stub.h).
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>  // Before defining dprintf, which POSIX stdio.h declares.
+#include <string.h>
+
+#include "host_sim_config.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+// PROGMEM
+///////////////////////////////////////////////////////////////////////////////
+
+#define PROGMEM
+#define PSTR(s) (s)
+#define pgm_read_byte(address) (*(const uint8_t*)(address))
+#define pgm_read_word(address) (*(const uint16_t*)(address))
+#define pgm_read_dword(address) (*(const uint32_t*)(address))
+#define pgm_read_ptr(address) (*(void* const*)(address))
+#define memcpy_P(dest, src, n) memcpy((dest), (src), (n))
+#define strlen_P(s) strlen(s)
+
+///////////////////////////////////////////////////////////////////////////////
+// Utilities
+///////////////////////////////////////////////////////////////////////////////
+
+#define ARRAY_SIZE(array) (sizeof(array) / sizeof((array)[0]))
+
+// Index of the highest set bit, as in QMK's util.h.
+static inline uint8_t biton(uint8_t bits) {
+  uint8_t n = 0;
+  while (bits >>= 1) {
+    ++n;
+  }
+  return n;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Keycodes
+///////////////////////////////////////////////////////////////////////////////
+
+enum qk_keycode_ranges {
+  QK_BASIC = 0x0000,
+  QK_BASIC_MAX = 0x00FF,
+  QK_MODS = 0x0100,
+  QK_MODS_MAX = 0x1FFF,
+  QK_MOD_TAP = 0x2000,
+  QK_MOD_TAP_MAX = 0x3FFF,
+  QK_LAYER_TAP = 0x4000,
+  QK_LAYER_TAP_MAX = 0x4FFF,
+  QK_LAYER_MOD = 0x5000,
+  QK_LAYER_MOD_MAX = 0x51FF,
+  QK_TO = 0x5200,
+  QK_TO_MAX = 0x521F,
+  QK_MOMENTARY = 0x5220,
+  QK_MOMENTARY_MAX = 0x523F,
+  QK_DEF_LAYER = 0x5240,
+  QK_DEF_LAYER_MAX = 0x525F,
+  QK_TOGGLE_LAYER = 0x5260,
+  QK_TOGGLE_LAYER_MAX = 0x527F,
+  QK_ONE_SHOT_LAYER = 0x5280,
+  QK_ONE_SHOT_LAYER_MAX = 0x529F,
+  QK_ONE_SHOT_MOD = 0x52A0,
+  QK_ONE_SHOT_MOD_MAX = 0x52BF,
+  QK_LAYER_TAP_TOGGLE = 0x52C0,
+  QK_LAYER_TAP_TOGGLE_MAX = 0x52DF,
+  QK_PERSISTENT_DEF_LAYER = 0x52E0,
+  QK_PERSISTENT_DEF_LAYER_MAX = 0x52FF,
+  QK_SWAP_HANDS = 0x5600,
+  QK_SWAP_HANDS_MAX = 0x56FF,
+  QK_TAP_DANCE = 0x5700,
+  QK_TAP_DANCE_MAX = 0x57FF,
+  QK_QUANTUM = 0x7C00,
+  QK_QUANTUM_MAX = 0x7DFF,
+  QK_KB = 0x7E00,
+  QK_KB_MAX = 0x7E3F,
+  QK_USER = 0x7E40,
+  QK_USER_MAX = 0x7FFF,
+  QK_UNICODEMAP = 0x8000,
+  QK_UNICODEMAP_MAX = 0xBFFF,
+  QK_UNICODEMAP_PAIR = 0xC000,
+  QK_UNICODEMAP_PAIR_MAX = 0xFFFF,
+  QK_UNICODE = 0x8000,
+  QK_UNICODE_MAX = 0xFFFF,
+};
+
+enum qk_keycode_defines {
+  KC_NO = 0x0000,
+  KC_TRANSPARENT = 0x0001,
+  KC_A = 0x0004,
+  KC_B, KC_C, KC_D, KC_E, KC_F, KC_G, KC_H, KC_I, KC_J, KC_K, KC_L, KC_M,
+  KC_N, KC_O, KC_P, KC_Q, KC_R, KC_S, KC_T, KC_U, KC_V, KC_W, KC_X, KC_Y,
+  KC_Z,
+  KC_1 = 0x001E,
+  KC_2, KC_3, KC_4, KC_5, KC_6, KC_7, KC_8, KC_9, KC_0,
+  KC_ENTER = 0x0028,
+  KC_ESCAPE = 0x0029,
+  KC_BACKSPACE = 0x002A,
+  KC_TAB = 0x002B,
+  KC_SPACE = 0x002C,
+  KC_MINUS = 0x002D,
+  KC_EQUAL = 0x002E,
+  KC_LEFT_BRACKET = 0x002F,
+  KC_RIGHT_BRACKET = 0x0030,
+  KC_BACKSLASH = 0x0031,
+  KC_NONUS_HASH = 0x0032,
+  KC_SEMICOLON = 0x0033,
+  KC_QUOTE = 0x0034,
+  KC_GRAVE = 0x0035,
+  KC_COMMA = 0x0036,
+  KC_DOT = 0x0037,
+  KC_SLASH = 0x0038,
+  KC_CAPS_LOCK = 0x0039,
+  KC_F1 = 0x003A,
+  KC_F2, KC_F3, KC_F4, KC_F5, KC_F6, KC_F7, KC_F8, KC_F9, KC_F10, KC_F11,
+  KC_F12,
+  KC_PRINT_SCREEN = 0x0046,
+  KC_SCROLL_LOCK = 0x0047,
+  KC_PAUSE = 0x0048,
+  KC_INSERT = 0x0049,
+  KC_HOME = 0x004A,
+  KC_PAGE_UP = 0x004B,
+  KC_DELETE = 0x004C,
+  KC_END = 0x004D,
+  KC_PAGE_DOWN = 0x004E,
+  KC_RIGHT = 0x004F,
+  KC_LEFT = 0x0050,
+  KC_DOWN = 0x0051,
+  KC_UP = 0x0052,
+  KC_NUM_LOCK = 0x0053,
+  KC_KP_SLASH = 0x0054,
+  KC_KP_ASTERISK = 0x0055,
+  KC_KP_MINUS = 0x0056,
+  KC_KP_PLUS = 0x0057,
+  KC_KP_ENTER = 0x0058,
+  KC_KP_1 = 0x0059,
+  KC_KP_2, KC_KP_3, KC_KP_4, KC_KP_5, KC_KP_6, KC_KP_7, KC_KP_8, KC_KP_9,
+  KC_KP_0,
+  KC_KP_DOT = 0x0063,
+  KC_NONUS_BACKSLASH = 0x0064,
+  KC_APPLICATION = 0x0065,
+  KC_F13 = 0x0068,
+  KC_F14, KC_F15, KC_F16, KC_F17, KC_F18, KC_F19, KC_F20, KC_F21, KC_F22,
+  KC_F23, KC_F24,
+  KC_SYSTEM_POWER = 0x00A5,
+  KC_SYSTEM_SLEEP = 0x00A6,
+  KC_SYSTEM_WAKE = 0x00A7,
+  KC_AUDIO_MUTE = 0x00A8,
+  KC_AUDIO_VOL_UP = 0x00A9,
+  KC_AUDIO_VOL_DOWN = 0x00AA,
+  KC_MEDIA_NEXT_TRACK = 0x00AB,
+  KC_MEDIA_PREV_TRACK = 0x00AC,
+  KC_MEDIA_STOP = 0x00AD,
+  KC_MEDIA_PLAY_PAUSE = 0x00AE,
+  KC_MEDIA_SELECT = 0x00AF,
+  KC_MEDIA_EJECT = 0x00B0,
+  KC_MAIL = 0x00B1,
+  KC_CALCULATOR = 0x00B2,
+  KC_MY_COMPUTER = 0x00B3,
+  KC_WWW_SEARCH = 0x00B4,
+  KC_WWW_HOME = 0x00B5,
+  KC_WWW_BACK = 0x00B6,
+  KC_WWW_FORWARD = 0x00B7,
+  KC_WWW_STOP = 0x00B8,
+  KC_WWW_REFRESH = 0x00B9,
+  KC_WWW_FAVORITES = 0x00BA,
+  KC_MEDIA_FAST_FORWARD = 0x00BB,
+  KC_MEDIA_REWIND = 0x00BC,
+  KC_BRIGHTNESS_UP = 0x00BD,
+  KC_BRIGHTNESS_DOWN = 0x00BE,
+  MS_UP = 0x00CD,
+  MS_DOWN = 0x00CE,
+  MS_LEFT = 0x00CF,
+  MS_RGHT = 0x00D0,
+  MS_BTN1 = 0x00D1,
+  MS_BTN2, MS_BTN3, MS_BTN4, MS_BTN5, MS_BTN6, MS_BTN7, MS_BTN8,
+  MS_WHLU = 0x00D9,
+  MS_WHLD = 0x00DA,
+  MS_WHLL = 0x00DB,
+  MS_WHLR = 0x00DC,
+  MS_ACL0 = 0x00DD,
+  MS_ACL1 = 0x00DE,
+  MS_ACL2 = 0x00DF,
+  KC_LEFT_CTRL = 0x00E0,
+  KC_LEFT_SHIFT = 0x00E1,
+  KC_LEFT_ALT = 0x00E2,
+  KC_LEFT_GUI = 0x00E3,
+  KC_RIGHT_CTRL = 0x00E4,
+  KC_RIGHT_SHIFT = 0x00E5,
+  KC_RIGHT_ALT = 0x00E6,
+  KC_RIGHT_GUI = 0x00E7,
+  QK_SWAP_HANDS_TOGGLE = 0x56F0,
+  QK_SWAP_HANDS_TAP_TOGGLE = 0x56F1,
+  QK_SWAP_HANDS_MOMENTARY_ON = 0x56F2,
+  QK_SWAP_HANDS_MOMENTARY_OFF = 0x56F3,
+  QK_SWAP_HANDS_OFF = 0x56F4,
+  QK_SWAP_HANDS_ON = 0x56F5,
+  QK_SWAP_HANDS_ONE_SHOT = 0x56F6,
+  QK_BOOTLOADER = 0x7C00,
+  QK_REBOOT = 0x7C01,
+  QK_DEBUG_TOGGLE = 0x7C02,
+  QK_CLEAR_EEPROM = 0x7C03,
+  QK_GRAVE_ESCAPE = 0x7C16,
+  QK_LEADER = 0x7C58,
+  QK_CAPS_WORD_TOGGLE = 0x7C73,
+  QK_TRI_LAYER_LOWER = 0x7C77,
+  QK_TRI_LAYER_UPPER = 0x7C78,
+  QK_REPEAT_KEY = 0x7C79,
+  QK_ALT_REPEAT_KEY = 0x7C7A,
+  QK_LAYER_LOCK = 0x7C7B,
+  QK_KB_0 = 0x7E00,
+  QK_USER_0 = 0x7E40,
+  SAFE_RANGE = QK_USER_0,
+};
+
+// Aliases.
+#define XXXXXXX KC_NO
+#define _______ KC_TRANSPARENT
+#define KC_TRNS KC_TRANSPARENT
+#define KC_ENT KC_ENTER
+#define KC_ESC KC_ESCAPE
+#define KC_BSPC KC_BACKSPACE
+#define KC_SPC KC_SPACE
+#define KC_MINS KC_MINUS
+#define KC_EQL KC_EQUAL
+#define KC_LBRC KC_LEFT_BRACKET
+#define KC_RBRC KC_RIGHT_BRACKET
+#define KC_BSLS KC_BACKSLASH
+#define KC_NUHS KC_NONUS_HASH
+#define KC_SCLN KC_SEMICOLON
+#define KC_QUOT KC_QUOTE
+#define KC_GRV KC_GRAVE
+#define KC_COMM KC_COMMA
+#define KC_SLSH KC_SLASH
+#define KC_CAPS KC_CAPS_LOCK
+#define KC_PSCR KC_PRINT_SCREEN
+#define KC_SCRL KC_SCROLL_LOCK
+#define KC_PAUS KC_PAUSE
+#define KC_INS KC_INSERT
+#define KC_PGUP KC_PAGE_UP
+#define KC_DEL KC_DELETE
+#define KC_PGDN KC_PAGE_DOWN
+#define KC_RGHT KC_RIGHT
+#define KC_NUM KC_NUM_LOCK
+#define KC_NUBS KC_NONUS_BACKSLASH
+#define KC_APP KC_APPLICATION
+#define KC_PWR KC_SYSTEM_POWER
+#define KC_MUTE KC_AUDIO_MUTE
+#define KC_VOLU KC_AUDIO_VOL_UP
+#define KC_VOLD KC_AUDIO_VOL_DOWN
+#define KC_MNXT KC_MEDIA_NEXT_TRACK
+#define KC_MPRV KC_MEDIA_PREV_TRACK
+#define KC_MSTP KC_MEDIA_STOP
+#define KC_MPLY KC_MEDIA_PLAY_PAUSE
+#define KC_WHOM KC_WWW_HOME
+#define KC_WBAK KC_WWW_BACK
+#define KC_WFWD KC_WWW_FORWARD
+#define KC_WSTP KC_WWW_STOP
+#define KC_WREF KC_WWW_REFRESH
+#define KC_MFFD KC_MEDIA_FAST_FORWARD
+#define KC_MRWD KC_MEDIA_REWIND
+#define KC_BRIU KC_BRIGHTNESS_UP
+#define KC_BRID KC_BRIGHTNESS_DOWN
+#define KC_LCTL KC_LEFT_CTRL
+#define KC_LSFT KC_LEFT_SHIFT
+#define KC_LALT KC_LEFT_ALT
+#define KC_LGUI KC_LEFT_GUI
+#define KC_RCTL KC_RIGHT_CTRL
+#define KC_RSFT KC_RIGHT_SHIFT
+#define KC_RALT KC_RIGHT_ALT
+#define KC_RGUI KC_RIGHT_GUI
+#define KC_MS_U MS_UP
+#define KC_MS_D MS_DOWN
+#define KC_MS_L MS_LEFT
+#define KC_MS_R MS_RGHT
+#define KC_WH_U MS_WHLU
+#define KC_WH_D MS_WHLD
+#define KC_WH_L MS_WHLL
+#define KC_WH_R MS_WHLR
+#define KC_MS_UP MS_UP
+#define KC_MS_ACCEL2 MS_ACL2
+#define QK_BOOT QK_BOOTLOADER
+#define DB_TOGG QK_DEBUG_TOGGLE
+#define EE_CLR QK_CLEAR_EEPROM
+#define QK_GESC QK_GRAVE_ESCAPE
+#define QK_LEAD QK_LEADER
+#define CW_TOGG QK_CAPS_WORD_TOGGLE
+#define TL_LOWR QK_TRI_LAYER_LOWER
+#define TL_UPPR QK_TRI_LAYER_UPPER
+#define QK_REP QK_REPEAT_KEY
+#define QK_AREP QK_ALT_REPEAT_KEY
+#define QK_LLCK QK_LAYER_LOCK
+#define SH_TOGG QK_SWAP_HANDS_TOGGLE
+#define SH_TT QK_SWAP_HANDS_TAP_TOGGLE
+#define SH_MON QK_SWAP_HANDS_MOMENTARY_ON
+#define SH_MOFF QK_SWAP_HANDS_MOMENTARY_OFF
+#define SH_OFF QK_SWAP_HANDS_OFF
+#define SH_ON QK_SWAP_HANDS_ON
+#define SH_OS QK_SWAP_HANDS_ONE_SHOT
+
+// Modifier-wrapped keycodes.
+#define QK_LCTL 0x0100
+#define QK_LSFT 0x0200
+#define QK_LALT 0x0400
+#define QK_LGUI 0x0800
+#define QK_RMODS_MIN 0x1000
+#define QK_RCTL 0x1100
+#define QK_RSFT 0x1200
+#define QK_RALT 0x1400
+#define QK_RGUI 0x1800
+
+#define LCTL(kc) (QK_LCTL | (kc))
+#define LSFT(kc) (QK_LSFT | (kc))
+#define LALT(kc) (QK_LALT | (kc))
+#define LGUI(kc) (QK_LGUI | (kc))
+#define RCTL(kc) (QK_RCTL | (kc))
+#define RSFT(kc) (QK_RSFT | (kc))
+#define RALT(kc) (QK_RALT | (kc))
+#define RGUI(kc) (QK_RGUI | (kc))
+#define C(kc) LCTL(kc)
+#define S(kc) LSFT(kc)
+#define A(kc) LALT(kc)
+#define G(kc) LGUI(kc)
+#define HYPR(kc) (QK_LCTL | QK_LSFT | QK_LALT | QK_LGUI | (kc))
+#define MEH(kc) (QK_LCTL | QK_LSFT | QK_LALT | (kc))
+
+#define KC_EXLM S(KC_1)
+#define KC_AT S(KC_2)
+#define KC_HASH S(KC_3)
+#define KC_DLR S(KC_4)
+#define KC_PERC S(KC_5)
+#define KC_CIRC S(KC_6)
+#define KC_AMPR S(KC_7)
+#define KC_ASTR S(KC_8)
+#define KC_LPRN S(KC_9)
+#define KC_RPRN S(KC_0)
+#define KC_UNDS S(KC_MINS)
+#define KC_PLUS S(KC_EQL)
+#define KC_LCBR S(KC_LBRC)
+#define KC_RCBR S(KC_RBRC)
+#define KC_PIPE S(KC_BSLS)
+#define KC_COLN S(KC_SCLN)
+#define KC_DQUO S(KC_QUOT)
+#define KC_TILD S(KC_GRV)
+#define KC_LABK S(KC_COMM)
+#define KC_RABK S(KC_DOT)
+#define KC_QUES S(KC_SLSH)
+#define KC_HYPR HYPR(KC_NO)
+#define KC_MEH MEH(KC_NO)
+
+// Modifier bits.
+enum mods_bit {
+  MOD_LCTL = 0x01,
+  MOD_LSFT = 0x02,
+  MOD_LALT = 0x04,
+  MOD_LGUI = 0x08,
+  MOD_RCTL = 0x11,
+  MOD_RSFT = 0x12,
+  MOD_RALT = 0x14,
+  MOD_RGUI = 0x18,
+  MOD_HYPR = 0x0F,
+  MOD_MEH = 0x07,
+};
+
+#define MOD_BIT(code) (1 << ((code) & 0x07))
+#define MOD_BIT_LCTRL MOD_BIT(KC_LEFT_CTRL)
+#define MOD_BIT_LSHIFT MOD_BIT(KC_LEFT_SHIFT)
+#define MOD_BIT_LALT MOD_BIT(KC_LEFT_ALT)
+#define MOD_BIT_LGUI MOD_BIT(KC_LEFT_GUI)
+#define MOD_BIT_RCTRL MOD_BIT(KC_RIGHT_CTRL)
+#define MOD_BIT_RSHIFT MOD_BIT(KC_RIGHT_SHIFT)
+#define MOD_BIT_RALT MOD_BIT(KC_RIGHT_ALT)
+#define MOD_BIT_RGUI MOD_BIT(KC_RIGHT_GUI)
+#define MOD_MASK_CTRL (MOD_BIT_LCTRL | MOD_BIT_RCTRL)
+#define MOD_MASK_SHIFT (MOD_BIT_LSHIFT | MOD_BIT_RSHIFT)
+#define MOD_MASK_ALT (MOD_BIT_LALT | MOD_BIT_RALT)
+#define MOD_MASK_GUI (MOD_BIT_LGUI | MOD_BIT_RGUI)
+#define MOD_MASK_CS (MOD_MASK_CTRL | MOD_MASK_SHIFT)
+#define MOD_MASK_CA (MOD_MASK_CTRL | MOD_MASK_ALT)
+#define MOD_MASK_CG (MOD_MASK_CTRL | MOD_MASK_GUI)
+#define MOD_MASK_SA (MOD_MASK_SHIFT | MOD_MASK_ALT)
+#define MOD_MASK_SG (MOD_MASK_SHIFT | MOD_MASK_GUI)
+#define MOD_MASK_AG (MOD_MASK_ALT | MOD_MASK_GUI)
+#define MOD_MASK_CSA (MOD_MASK_CTRL | MOD_MASK_SHIFT | MOD_MASK_ALT)
+#define MOD_MASK_CSAG (MOD_MASK_CSA | MOD_MASK_GUI)
+
+// Keycode constructors.
+#define MT(mod, kc) (QK_MOD_TAP | (((mod) & 0x1F) << 8) | ((kc) & 0xFF))
+#define LT(layer, kc) (QK_LAYER_TAP | (((layer) & 0xF) << 8) | ((kc) & 0xFF))
+#define LM(layer, mod) (QK_LAYER_MOD | (((layer) & 0xF) << 5) | ((mod) & 0x1F))
+#define TO(layer) (QK_TO | ((layer) & 0x1F))
+#define MO(layer) (QK_MOMENTARY | ((layer) & 0x1F))
+#define DF(layer) (QK_DEF_LAYER | ((layer) & 0x1F))
+#define TG(layer) (QK_TOGGLE_LAYER | ((layer) & 0x1F))
+#define OSL(layer) (QK_ONE_SHOT_LAYER | ((layer) & 0x1F))
+#define OSM(mod) (QK_ONE_SHOT_MOD | ((mod) & 0x1F))
+#define TT(layer) (QK_LAYER_TAP_TOGGLE | ((layer) & 0x1F))
+#define PDF(layer) (QK_PERSISTENT_DEF_LAYER | ((layer) & 0x1F))
+#define SH_T(kc) (QK_SWAP_HANDS | ((kc) & 0xFF))
+#define TD(i) (QK_TAP_DANCE | ((i) & 0xFF))
+#define UC(c) (QK_UNICODE | (c))
+#define LCTL_T(kc) MT(MOD_LCTL, kc)
+#define LSFT_T(kc) MT(MOD_LSFT, kc)
+#define LALT_T(kc) MT(MOD_LALT, kc)
+#define LGUI_T(kc) MT(MOD_LGUI, kc)
+#define RCTL_T(kc) MT(MOD_RCTL, kc)
+#define RSFT_T(kc) MT(MOD_RSFT, kc)
+#define RALT_T(kc) MT(MOD_RALT, kc)
+#define RGUI_T(kc) MT(MOD_RGUI, kc)
+#define KC_LCPO MT(MOD_LCTL, KC_LPRN)
+
+// Keycode range tests and field extraction.
+#define IS_QK_BASIC(code) ((code) >= QK_BASIC && (code) <= QK_BASIC_MAX)
+#define IS_QK_MODS(code) ((code) >= QK_MODS && (code) <= QK_MODS_MAX)
+#define IS_QK_MOD_TAP(code) ((code) >= QK_MOD_TAP && (code) <= QK_MOD_TAP_MAX)
+#define IS_QK_LAYER_TAP(code) \
+  ((code) >= QK_LAYER_TAP && (code) <= QK_LAYER_TAP_MAX)
+#define IS_QK_LAYER_MOD(code) \
+  ((code) >= QK_LAYER_MOD && (code) <= QK_LAYER_MOD_MAX)
+#define IS_QK_TO(code) ((code) >= QK_TO && (code) <= QK_TO_MAX)
+#define IS_QK_MOMENTARY(code) \
+  ((code) >= QK_MOMENTARY && (code) <= QK_MOMENTARY_MAX)
+#define IS_QK_TOGGLE_LAYER(code) \
+  ((code) >= QK_TOGGLE_LAYER && (code) <= QK_TOGGLE_LAYER_MAX)
+#define IS_QK_ONE_SHOT_LAYER(code) \
+  ((code) >= QK_ONE_SHOT_LAYER && (code) <= QK_ONE_SHOT_LAYER_MAX)
+#define IS_QK_ONE_SHOT_MOD(code) \
+  ((code) >= QK_ONE_SHOT_MOD && (code) <= QK_ONE_SHOT_MOD_MAX)
+#define IS_QK_LAYER_TAP_TOGGLE(code) \
+  ((code) >= QK_LAYER_TAP_TOGGLE && (code) <= QK_LAYER_TAP_TOGGLE_MAX)
+#define IS_QK_SWAP_HANDS(code) \
+  ((code) >= QK_SWAP_HANDS && (code) <= QK_SWAP_HANDS_MAX)
+#define IS_QK_TAP_DANCE(code) \
+  ((code) >= QK_TAP_DANCE && (code) <= QK_TAP_DANCE_MAX)
+#define IS_QK_KB(code) ((code) >= QK_KB && (code) <= QK_KB_MAX)
+#define IS_QK_USER(code) ((code) >= QK_USER && (code) <= QK_USER_MAX)
+#define IS_QK_UNICODE(code) ((code) >= QK_UNICODE && (code) <= QK_UNICODE_MAX)
+#define MODIFIER_KEYCODE_RANGE KC_LEFT_CTRL ... KC_RIGHT_GUI
+#define KB_KEYCODE_RANGE QK_KB ... QK_KB_MAX
+#define USER_KEYCODE_RANGE QK_USER ... QK_USER_MAX
+#define IS_MODIFIER_KEYCODE(code) \
+  ((code) >= KC_LEFT_CTRL && (code) <= KC_RIGHT_GUI)
+#define IS_MOUSE_KEYCODE(code) ((code) >= KC_MS_UP && (code) <= KC_MS_ACCEL2)
+#define IS_SWAP_HANDS_KEYCODE(code) \
+  ((code) >= QK_SWAP_HANDS_TOGGLE && (code) <= QK_SWAP_HANDS_ONE_SHOT)
+
+#define QK_MODS_GET_MODS(kc) (((kc) >> 8) & 0x1F)
+#define QK_MODS_GET_BASIC_KEYCODE(kc) ((kc) & 0xFF)
+#define QK_MOD_TAP_GET_MODS(kc) (((kc) >> 8) & 0x1F)
+#define QK_MOD_TAP_GET_TAP_KEYCODE(kc) ((kc) & 0xFF)
+#define QK_LAYER_TAP_GET_LAYER(kc) (((kc) >> 8) & 0xF)
+#define QK_LAYER_TAP_GET_TAP_KEYCODE(kc) ((kc) & 0xFF)
+#define QK_LAYER_MOD_GET_LAYER(kc) (((kc) >> 5) & 0xF)
+#define QK_LAYER_MOD_GET_MODS(kc) ((kc) & 0x1F)
+#define QK_TO_GET_LAYER(kc) ((kc) & 0x1F)
+#define QK_MOMENTARY_GET_LAYER(kc) ((kc) & 0x1F)
+#define QK_DEF_LAYER_GET_LAYER(kc) ((kc) & 0x1F)
+#define QK_TOGGLE_LAYER_GET_LAYER(kc) ((kc) & 0x1F)
+#define QK_ONE_SHOT_LAYER_GET_LAYER(kc) ((kc) & 0x1F)
+#define QK_ONE_SHOT_MOD_GET_MODS(kc) ((kc) & 0x1F)
+#define QK_LAYER_TAP_TOGGLE_GET_LAYER(kc) ((kc) & 0x1F)
+#define QK_PERSISTENT_DEF_LAYER_GET_LAYER(kc) ((kc) & 0x1F)
+#define QK_SWAP_HANDS_GET_TAP_KEYCODE(kc) ((kc) & 0xFF)
+#define QK_TAP_DANCE_GET_INDEX(kc) ((kc) & 0xFF)
+#define QK_UNICODE_GET_CODE_POINT(kc) ((kc) & 0x7FFF)
+#define QK_UNICODEMAP_GET_INDEX(kc) ((kc) & 0x3FFF)
+#define QK_UNICODEMAP_PAIR_GET_UNSHIFTED_INDEX(kc) ((kc) & 0x7F)
+#define QK_UNICODEMAP_PAIR_GET_SHIFTED_INDEX(kc) (((kc) >> 7) & 0x7F)
+
+///////////////////////////////////////////////////////////////////////////////
+// Key events
+///////////////////////////////////////////////////////////////////////////////
+
+typedef struct {
+  uint8_t col;
+  uint8_t row;
+} keypos_t;
+
+typedef enum keyevent_type_t {
+  TICK_EVENT = 0,
+  KEY_EVENT = 1,
+  ENCODER_CW_EVENT = 2,
+  ENCODER_CCW_EVENT = 3,
+  COMBO_EVENT = 4,
+} keyevent_type_t;
+
+typedef struct {
+  keypos_t key;
+  uint16_t time;
+  keyevent_type_t type;
+  bool pressed;
+} keyevent_t;
+
+typedef struct {
+  bool interrupted : 1;
+  bool reserved2 : 1;
+  bool reserved1 : 1;
+  bool reserved0 : 1;
+  uint8_t count : 4;
+} tap_t;
+
+typedef struct {
+  keyevent_t event;
+  tap_t tap;
+  uint16_t keycode;
+} keyrecord_t;
+
+#define IS_EVENT(event) ((event).type != TICK_EVENT)
+#define IS_KEYEVENT(event) ((event).type == KEY_EVENT)
+#define IS_COMBOEVENT(event) ((event).type == COMBO_EVENT)
+#define MAKE_KEYEVENT(row_num, col_num, press)                           \
+  ((keyevent_t){.key = ((keypos_t){.row = (row_num), .col = (col_num)}), \
+                .pressed = (press),                                      \
+                .time = timer_read(),                                    \
+                .type = KEY_EVENT})
+
+/** Runs `record` through the handler chain and default key handling. */
+void process_record(keyrecord_t* record);
+
+// Actions, as far as Achordion uses them to apply mods directly.
+enum action_kind_id {
+  ACT_LMODS = 0x0,
+  ACT_RMODS = 0x1,
+  ACT_LMODS_TAP = 0x2,
+  ACT_RMODS_TAP = 0x3,
+};
+
+typedef union {
+  uint16_t code;
+} action_t;
+
+#define ACTION(kind, param) ((kind) << 12 | (param))
+#define ACTION_MODS_KEY(mods, key)                               \
+  ACTION(((mods) & 0x10) ? ACT_RMODS : ACT_LMODS,                \
+         ((mods) & 0xf) << 8 | (key))
+#define ACTION_MODS(mods) ACTION_MODS_KEY(mods, 0)
+#define ACTION_MODS_TAP_KEY(mods, key)                           \
+  ACTION(((mods) & 0x10) ? ACT_RMODS_TAP : ACT_LMODS_TAP,        \
+         ((mods) & 0xf) << 8 | (key))
+/** Performs `action` for `record`, bypassing the handler chain. */
+void process_action(keyrecord_t* record, action_t action);
+#define mod_config(mod) (mod)
+/** The keymap handler chain, defined by the replay driver. */
+bool process_record_user(uint16_t keycode, keyrecord_t* record);
+/** Looks up the keycode for `key` on `layer`; the driver's keymap. */
+uint16_t keymap_key_to_keycode(uint8_t layer, keypos_t key);
+
+#ifndef MATRIX_ROWS
+#define MATRIX_ROWS 8
+#endif  // MATRIX_ROWS
+#ifndef MATRIX_COLS
+#define MATRIX_COLS 8
+#endif  // MATRIX_COLS
+
+///////////////////////////////////////////////////////////////////////////////
+// Timers, waits, and debug output
+///////////////////////////////////////////////////////////////////////////////
+
+uint16_t timer_read(void);
+uint32_t timer_read32(void);
+#define timer_elapsed(last) ((uint16_t)(timer_read() - (last)))
+#define timer_elapsed32(last) ((uint32_t)(timer_read32() - (last)))
+#define timer_expired(current, future) \
+  ((uint16_t)((current) - (future)) < UINT16_C(0x8000))
+#define timer_expired32(current, future) \
+  ((uint32_t)((current) - (future)) < UINT32_C(0x80000000))
+void wait_ms(uint16_t ms);
+
+extern bool debug_enable;
+int host_sim_printf(const char* fmt, ...);
+int8_t sendchar(uint8_t c);
+#define xprintf host_sim_printf
+#define uprintf host_sim_printf
+#define dprintf(...)                 \
+  do {                               \
+    if (debug_enable) {              \
+      host_sim_printf(__VA_ARGS__);  \
+    }                                \
+  } while (0)
+#define dprint(s) dprintf("%s", (s))
+#define dprintln(s) dprintf("%s\n", (s))
+#define print(s) host_sim_printf("%s", (s))
+
+///////////////////////////////////////////////////////////////////////////////
+// EEPROM
+///////////////////////////////////////////////////////////////////////////////
+
+// The user data block, held in RAM. It starts out zeroed, like an erased
+// block that failed validation.
+uint32_t eeconfig_read_user_datablock(void* data, uint32_t offset,
+                                      uint32_t length);
+uint32_t eeconfig_update_user_datablock(const void* data, uint32_t offset,
+                                        uint32_t length);
+
+///////////////////////////////////////////////////////////////////////////////
+// Layers
+///////////////////////////////////////////////////////////////////////////////
+
+typedef uint32_t layer_state_t;
+#define MAX_LAYER 32
+extern layer_state_t layer_state;
+extern layer_state_t default_layer_state;
+#define IS_LAYER_ON(layer) layer_state_is(layer)
+#define IS_LAYER_ON_STATE(state, layer) (((state) >> (layer)) & 1)
+
+bool layer_state_is(uint8_t layer);
+void layer_on(uint8_t layer);
+void layer_off(uint8_t layer);
+void layer_invert(uint8_t layer);
+void layer_move(uint8_t layer);
+void layer_clear(void);
+void layer_and(layer_state_t state);
+void layer_or(layer_state_t state);
+void layer_state_set(layer_state_t state);
+uint8_t get_highest_layer(layer_state_t state);
+uint8_t read_source_layers_cache(keypos_t key);
+
+///////////////////////////////////////////////////////////////////////////////
+// Modifiers and keyboard reports
+///////////////////////////////////////////////////////////////////////////////
+
+uint8_t get_mods(void);
+void set_mods(uint8_t mods);
+void add_mods(uint8_t mods);
+void del_mods(uint8_t mods);
+void clear_mods(void);
+uint8_t get_weak_mods(void);
+void set_weak_mods(uint8_t mods);
+void add_weak_mods(uint8_t mods);
+void del_weak_mods(uint8_t mods);
+void clear_weak_mods(void);
+uint8_t get_oneshot_mods(void);
+void set_oneshot_mods(uint8_t mods);
+void add_oneshot_mods(uint8_t mods);
+void del_oneshot_mods(uint8_t mods);
+void clear_oneshot_mods(void);
+bool is_oneshot_layer_active(void);
+uint8_t get_oneshot_layer(void);
+void clear_oneshot_layer_state(uint8_t state);
+void reset_oneshot_layer(void);
+#define ONESHOT_PRESSED 0b01
+#define ONESHOT_OTHER_KEY_PRESSED 0b10
+#define ONESHOT_START 0b11
+
+void register_code(uint8_t code);
+void unregister_code(uint8_t code);
+void tap_code(uint8_t code);
+void tap_code_delay(uint8_t code, uint16_t delay);
+void register_code16(uint16_t code);
+void unregister_code16(uint16_t code);
+void tap_code16(uint16_t code);
+void tap_code16_delay(uint16_t code, uint16_t delay);
+void register_mods(uint8_t mods);
+void unregister_mods(uint8_t mods);
+void register_weak_mods(uint8_t mods);
+void unregister_weak_mods(uint8_t mods);
+void add_key(uint8_t key);
+void del_key(uint8_t key);
+void send_keyboard_report(void);
+void clear_keyboard(void);
+
+typedef union {
+  uint8_t raw;
+  struct {
+    bool num_lock : 1;
+    bool caps_lock : 1;
+    bool scroll_lock : 1;
+    bool compose : 1;
+    bool kana : 1;
+    uint8_t reserved : 3;
+  };
+} led_t;
+led_t host_keyboard_led_state(void);
+
+///////////////////////////////////////////////////////////////////////////////
+// Mouse reports
+///////////////////////////////////////////////////////////////////////////////
+
+#ifdef MOUSE_EXTENDED_REPORT
+typedef int16_t mouse_xy_report_t;
+#else
+typedef int8_t mouse_xy_report_t;
+#endif  // MOUSE_EXTENDED_REPORT
+
+typedef struct {
+  uint8_t report_id;
+  uint8_t buttons;
+  mouse_xy_report_t x;
+  mouse_xy_report_t y;
+  int8_t v;
+  int8_t h;
+} report_mouse_t;
+
+void host_mouse_send(report_mouse_t* report);
+
+///////////////////////////////////////////////////////////////////////////////
+// Send String
+///////////////////////////////////////////////////////////////////////////////
+
+#define SS_QMK_PREFIX 1
+#define SS_TAP_CODE 1
+#define SS_DOWN_CODE 2
+#define SS_UP_CODE 3
+#define SS_DELAY_CODE 4
+
+#define HOST_SIM_STRINGIZE_(x) #x
+#define HOST_SIM_STRINGIZE(x) HOST_SIM_STRINGIZE_(x)
+#define HOST_SIM_ADD_SLASH_X(y) HOST_SIM_STRINGIZE(\x##y)
+#define HOST_SIM_SYMBOL_STR(x) HOST_SIM_ADD_SLASH_X(x)
+
+#define SS_TAP(keycode) "\1\1" HOST_SIM_SYMBOL_STR(keycode)
+#define SS_DOWN(keycode) "\1\2" HOST_SIM_SYMBOL_STR(keycode)
+#define SS_UP(keycode) "\1\3" HOST_SIM_SYMBOL_STR(keycode)
+#define SS_DELAY(msecs) "\1\4" HOST_SIM_STRINGIZE(msecs) "|"
+#define SS_LCTL(string) SS_DOWN(X_LCTL) string SS_UP(X_LCTL)
+#define SS_LSFT(string) SS_DOWN(X_LSFT) string SS_UP(X_LSFT)
+#define SS_LALT(string) SS_DOWN(X_LALT) string SS_UP(X_LALT)
+#define SS_LGUI(string) SS_DOWN(X_LGUI) string SS_UP(X_LGUI)
+
+#define X_BSPC 2a
+#define X_DEL 4c
+#define X_RGHT 4f
+#define X_LEFT 50
+#define X_DOWN 51
+#define X_UP 52
+#define X_HOME 4a
+#define X_END 4d
+#define X_LCTL e0
+#define X_LSFT e1
+#define X_LALT e2
+#define X_LGUI e3
+
+void send_string(const char* str);
+void send_string_with_delay(const char* str, uint8_t interval);
+#define send_string_P(str) send_string(str)
+#define send_string_with_delay_P(str, interval) \
+  send_string_with_delay((str), (interval))
+#define SEND_STRING(string) send_string(string)
+void send_char(char ascii_code);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,209 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file trace_decode.c
+ * @brief Host-side decoder of Event Trace records
+ *
+ * Pretty-prints the key event records of features/event_trace.h, formatting
+ * keycodes with features/keycode_string.c, in the same layout as the keymaps'
+ * `dlog_record()`:
+ *
+ *     ./trace_decode [-r | -t] [file ...]
+ *
+ * By default, the input is console text, as captured with hid_listen or
+ * `qmk console`. Records are found as "ET" and 16 hex digits anywhere in a
+ * line, and other text is ignored. With -r, the input is instead binary raw
+ * HID reports of 32 bytes. Input is read from stdin if no files are given.
+ *
+ * With -t, the input is text logging from a keymap built with
+ * `KEYCODE_STRING_NUMERIC=yes`. Every line is printed, with hex values like
+ * "0x7E40" replaced by keycode names.
+ *
+ * Besides the common names in keycode_string.c, the keymap's custom keycodes
+ * are named, from keycode_names.h as generated by gen_keycode_names.py. Pick
+ * the keymap with `make clean trace_decode KEYMAP=../../getreuer.c`.
+ *
+ * Keycodes are formatted with the keycode values of the stubbed QMK core in
+ * quantum.h, so they may be off for keycodes that QMK has since renumbered.
+ */
+
+#include <ctype.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "features/event_trace.h"
+#include "features/keycode_string.h"
+#include "keycode_names.h"
+#include "qmk_stub.h"
+
+enum { RAW_REPORT_SIZE = 32 };
+
+// Time since the first record, in milliseconds.
+static long time_ms = 0;
+
+static void print_record(const event_trace_record_t* record) {
+  time_ms += record->delta_ms;
+  printf("%8ld ms  ", time_ms);
+
+  if (record->flags & EVENT_TRACE_FLAG_DROPPED) {
+    printf("(dropped %u events)\n", record->keycode);
+    return;
+  }
+
+  printf("L%-2u ", record->layer);  // Log the layer.
+  if (record->flags & EVENT_TRACE_FLAG_COMBO) {
+    printf("combo   ");
+  } else {  // Log the "(row,col)" position.
+    printf("(%2u,%2u) ", record->row, record->col);
+  }
+  const char* tap_hold = "";
+  if (record->flags & EVENT_TRACE_FLAG_TAP_HOLD) {
+    tap_hold = (record->flags & EVENT_TRACE_FLAG_TAP) ? "tap" : "hold";
+  }
+  char name[KEYCODE_STRING_MAX_LEN + 1];
+  get_keycode_string_r(record->keycode, name, sizeof(name));
+  printf("%-4s %-7s %s\n", tap_hold,
+         (record->flags & EVENT_TRACE_FLAG_PRESSED) ? "press" : "release",
+         name);
+}
+
+static int hex_value(char c) {
+  if ('0' <= c && c <= '9') {
+    return c - '0';
+  } else if ('A' <= c && c <= 'F') {
+    return c - 'A' + 10;
+  } else if ('a' <= c && c <= 'f') {
+    return c - 'a' + 10;
+  }
+  return -1;
+}
+
+// Parses `EVENT_TRACE_RECORD_SIZE` bytes in hex from `s`.
+static bool parse_hex_record(const char* s, uint8_t* bytes) {
+  for (int i = 0; i < EVENT_TRACE_RECORD_SIZE; ++i) {
+    const int hi = hex_value(s[2 * i]);
+    const int lo = (hi >= 0) ? hex_value(s[2 * i + 1]) : -1;
+    if (lo < 0) {
+      return false;
+    }
+    bytes[i] = (uint8_t)(hi << 4 | lo);
+  }
+  return true;
+}
+
+// Prints `line`, replacing each "0x" and 4 hex digits with a keycode name.
+static void translate_line(const char* line) {
+  const char* s = line;
+  while (*s) {
+    if (s[0] == '0' && s[1] == 'x' &&
+        (s == line || !isalnum((unsigned char)s[-1]))) {
+      uint16_t keycode = 0;
+      int n = 0;
+      int digit;
+      while (n < 4 && (digit = hex_value(s[2 + n])) >= 0) {
+        keycode = keycode << 4 | digit;
+        ++n;
+      }
+      if (n == 4 && !isalnum((unsigned char)s[6])) {
+        char name[KEYCODE_STRING_MAX_LEN + 1];
+        get_keycode_string_r(keycode, name, sizeof(name));
+        fputs(name, stdout);
+        s += 6;
+        continue;
+      }
+    }
+    putchar(*s++);
+  }
+}
+
+static void translate_text(FILE* f) {
+  char line[256];
+  while (fgets(line, sizeof(line), f)) {
+    translate_line(line);
+  }
+}
+
+static void decode_text(FILE* f) {
+  char line[256];
+  while (fgets(line, sizeof(line), f)) {
+    for (const char* s = strstr(line, "ET"); s; s = strstr(s + 1, "ET")) {
+      uint8_t bytes[EVENT_TRACE_RECORD_SIZE];
+      if (strlen(s + 2) >= 2 * EVENT_TRACE_RECORD_SIZE &&
+          parse_hex_record(s + 2, bytes) &&
+          !isxdigit((unsigned char)s[2 + 2 * EVENT_TRACE_RECORD_SIZE])) {
+        event_trace_record_t record;
+        event_trace_deserialize(bytes, &record);
+        print_record(&record);
+        break;
+      }
+    }
+  }
+}
+
+static void decode_raw_hid(FILE* f) {
+  uint8_t report[RAW_REPORT_SIZE];
+  while (fread(report, sizeof(report), 1, f) == 1) {
+    if (report[0] != EVENT_TRACE_RAW_HID_ID) {
+      continue;  // Not an Event Trace report.
+    }
+    const int capacity = (RAW_REPORT_SIZE - 2) / EVENT_TRACE_RECORD_SIZE;
+    const int n = (report[1] < capacity) ? report[1] : capacity;
+    for (int i = 0; i < n; ++i) {
+      event_trace_record_t record;
+      event_trace_deserialize(report + 2 + i * EVENT_TRACE_RECORD_SIZE,
+                              &record);
+      print_record(&record);
+    }
+  }
+}
+
+int main(int argc, char** argv) {
+  bool raw_hid = false;
+  void (*decode)(FILE*) = decode_text;
+  int num_files = 0;
+  for (int i = 1; i < argc; ++i) {
+    if (strcmp(argv[i], "-r") == 0) {
+      raw_hid = true;
+      decode = decode_raw_hid;
+    } else if (strcmp(argv[i], "-t") == 0) {
+      raw_hid = false;
+      decode = translate_text;
+    } else if (argv[i][0] == '-') {
+      fprintf(stderr, "Usage: %s [-r | -t] [file ...]\n", argv[0]);
+      return 1;
+    } else {
+      FILE* f = fopen(argv[i], raw_hid ? "rb" : "r");
+      if (!f) {
+        perror(argv[i]);
+        return 1;
+      }
+      decode(f);
+      fclose(f);
+      ++num_files;
+    }
+  }
+  if (!num_files) {
+    decode(stdin);
+  }
+  return 0;
+}
+
+// The decoder links the stubbed QMK core, but simulates no keyboard.
+void host_sim_on_keyboard_report(const host_sim_report_t* prev,
+                                 const host_sim_report_t* report) {}
+void host_sim_on_mouse_report(const report_mouse_t* report) {}
+bool process_record_user(uint16_t keycode, keyrecord_t* record) {
+  return true;
+}